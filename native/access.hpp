@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../stats.sx.hpp"
+
+// private members of `sx::stats` used by native tools (befriended by the contract),
+// the contract itself is compiled separately (`stats_sx` library)
+namespace sx {
+
+struct native_access {
+    static stats::config_row get_config( stats & contract ) { return contract.get_config(); }
+
+    static void update_volume( stats & contract, const name code, const vector<stats::swaplog_record> & records, const stats::config_row & config )
+    {
+        contract.update_volume( code, records, config );
+    }
+
+    static void update_trades( stats & contract, const name code, const vector<stats::tradelog_record> & records, const stats::config_row & config )
+    {
+        contract.update_trades( code, records, config );
+    }
+
+    static void update_gateway( stats & contract, const name code, const vector<stats::gatewaylog_record> & records, const stats::config_row & config )
+    {
+        contract.update_gateway( code, records, config );
+    }
+
+    static map<symbol_code, vector<stats::quote_price>> get_spot_prices( stats & contract, const name code, const vector<symbol_code> & bases, const set<symbol_code> & symcodes )
+    {
+        return contract.get_spot_prices( code, bases, symcodes );
+    }
+
+    static void refresh_spot_prices( stats & contract, const name code, const vector<symbol_code> & bases )
+    {
+        contract.refresh_spot_prices( code, bases );
+    }
+
+    // fixed-point pricing
+    static constexpr int128_t PRICE_UNIT = stats::PRICE_UNIT;
+    static constexpr int128_t MAX_PRICE = stats::MAX_PRICE;
+
+    static int128_t div_price( const asset numerator, const asset denominator ) { return stats::div_price( numerator, denominator ); }
+    static int128_t div_fixed( const int128_t numerator, const int128_t denominator, int exponent ) { return stats::div_fixed( numerator, denominator, exponent ); }
+
+};
+
+}
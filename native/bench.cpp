@@ -0,0 +1,166 @@
+// native benchmark of stats.sx write paths over in-memory tables (`native/mock`)
+//
+// usage: ./bench [ops=2000] [max_keys=10000]
+//
+// for 1, 10, 100, 1k & 10k keys (symbols, traders, executors & exchanges), rows are first filled with every key
+// then `ops` records are applied, printing ns/op & the packed size of the contract row in `*.v2` / `prices`
+//
+// mock tables keep rows packed, so ns/op includes unpacking & packing rows as on chain
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/singleton.hpp>
+#include <eosio.token/eosio.token.hpp>
+#include <sx.swap/swap.sx.hpp>
+#include <sx.vaults/vaults.sx.hpp>
+
+#include "access.hpp"
+
+using namespace eosio;
+using namespace std;
+
+namespace {
+
+const symbol_code BASE{"USDT"};
+const uint8_t PRECISION = 4;
+
+// names & symbol codes from index (digits mapped to letters), same as `scripts/bench.sh`
+string to_letters( uint64_t i, char zero )
+{
+    string str = to_string( i );
+    for ( char & c : str ) c = zero + ( c - '0' );
+    return str;
+}
+
+symbol_code get_symcode( uint64_t i ) { return symbol_code{ "S" + to_letters( i, 'A' ) }; }
+name get_account( const char * prefix, uint64_t i ) { return name{ prefix + to_letters( i, 'a' ) }; }
+asset get_asset( int64_t amount, uint64_t i ) { return asset{ amount, symbol{ get_symcode( i ), PRECISION } }; }
+
+template <typename T>
+size_t row_size( const name scope, const uint64_t pk )
+{
+    T _table( "stats.sx"_n, scope.value );
+    const auto itr = _table.find( pk );
+    return itr == _table.end() ? 0 : pack_size( *itr );
+}
+
+// fresh "chain" with swap.sx tokens & vaults.sx vaults for every key
+void setup( const uint64_t keys )
+{
+    mock::reset();
+    mock::set_time( 1600000000 );
+
+    sx::swap::tokens _tokens( "swap.sx"_n, "swap.sx"_n.value );
+    sx::vaults::vault_table _vault( "vaults.sx"_n, "vaults.sx"_n.value );
+    const auto add_token = [&]( const asset reserve ) {
+        _tokens.emplace( "swap.sx"_n, [&]( auto & row ) {
+            row.sym = reserve.symbol;
+            row.contract = "token.sx"_n;
+            row.balance = reserve;
+            row.depth = reserve;
+            row.reserve = reserve;
+        });
+        _vault.emplace( "vaults.sx"_n, [&]( auto & row ) {
+            row.id = extended_symbol{ reserve.symbol, "token.sx"_n };
+            row.deposit = extended_asset{ reserve, "token.sx"_n };
+        });
+    };
+    add_token( asset{ 1'000'000'0000, symbol{ BASE, PRECISION } } );
+    for ( uint64_t i = 0; i < keys; ++i ) add_token( get_asset( 1'000'000'0000 + i * 1'0000, i ) );
+}
+
+void report( const char * op, const uint64_t keys, const uint64_t ops, const chrono::nanoseconds elapsed, const size_t bytes )
+{
+    const string size = bytes ? to_string( bytes ) : "-";
+    printf( "%-12s %8lu %12.0f %10s\n", op, keys, double( elapsed.count() ) / ops, size.c_str() );
+}
+
+// fill keys first (not timed), then time `ops` calls
+template <typename Op>
+chrono::nanoseconds run( const uint64_t keys, const uint64_t ops, const Op & op )
+{
+    uint64_t i = 0;
+    for ( ; i < keys; ++i ) op( i );
+
+    const auto start = chrono::steady_clock::now();
+    for ( const uint64_t end = i + ops; i < end; ++i ) {
+        mock::set_time( 1600000000 + i );
+        op( i );
+    }
+    return chrono::steady_clock::now() - start;
+}
+
+}
+
+int main( int argc, char ** argv )
+{
+    const uint64_t ops = argc > 1 ? strtoull( argv[1], nullptr, 10 ) : 2000;
+    const uint64_t max_keys = argc > 2 ? strtoull( argv[2], nullptr, 10 ) : 10000;
+
+    sx::stats stats( "stats.sx"_n, "stats.sx"_n, datastream<const char*>( nullptr, 0 ) );
+    const sx::stats::config_row config = sx::native_access::get_config( stats );
+    const vector<symbol_code> bases = { BASE };
+
+    printf( "%-12s %8s %12s %10s\n", "op", "keys", "ns/op", "row bytes" );
+    for ( uint64_t keys = 1; keys <= max_keys; keys *= 10 ) {
+        // swap.sx::swaplog
+        setup( keys );
+        auto elapsed = run( keys, ops, [&]( const uint64_t i ) {
+            const asset in = get_asset( 1'0000 + i, i % keys );
+            const asset out = get_asset( 1'0000 + i, ( i + 1 ) % keys );
+            sx::native_access::update_volume( stats, "swap.sx"_n, { { "swap.sx"_n, get_account( "trader", i % keys ), in, out, get_asset( 10, i % keys ) } }, config );
+        });
+        report( "volume", keys, ops, elapsed, row_size<sx::stats::volume>( "stats.sx"_n, "swap.sx"_n.value ) );
+
+        // flash.sx::flashlog
+        setup( keys );
+        elapsed = run( keys, ops, [&]( const uint64_t i ) {
+            const asset borrow = get_asset( 1'0000 + i, i % keys );
+            stats.on_flashlog( "basic.sx"_n, get_account( "trader", i % keys ), extended_asset{ borrow, "token.sx"_n }, get_asset( 1, i % keys ) );
+        });
+        report( "flash", keys, ops, elapsed, row_size<sx::stats::flash>( "stats.sx"_n, "basic.sx"_n.value ) );
+
+        // basic.sx::tradelog
+        setup( keys );
+        elapsed = run( keys, ops, [&]( const uint64_t i ) {
+            const asset borrow = get_asset( 1'0000 + i, i % keys );
+            const asset quote = get_asset( 1'0000 + i, ( i + 1 ) % keys );
+            sx::native_access::update_trades( stats, "basic.sx"_n, { { "basic.sx"_n, get_account( "executor", i % keys ), borrow, { borrow, quote }, { get_account( "swap", i % keys ) }, get_asset( 1, i % keys ) } }, config );
+        });
+        report( "trades", keys, ops, elapsed, row_size<sx::stats::trades>( "stats.sx"_n, "basic.sx"_n.value ) );
+
+        // gateway.sx::gatewaylog
+        setup( keys );
+        elapsed = run( keys, ops, [&]( const uint64_t i ) {
+            const asset in = get_asset( 1'0000 + i, i % keys );
+            const asset out = get_asset( 1'0000 + i, ( i + 1 ) % keys );
+            sx::native_access::update_gateway( stats, "gateway.sx"_n, { { "gateway.sx"_n, in, out, { get_account( "swap", i % keys ) }, get_asset( 0, ( i + 1 ) % keys ), get_asset( 0, ( i + 1 ) % keys ) } }, config );
+        });
+        report( "gateway", keys, ops, elapsed, row_size<sx::stats::gateway>( "stats.sx"_n, "gateway.sx"_n.value ) );
+
+        // quotes of a traded pair & full refresh (every token of swap.sx)
+        setup( keys );
+        elapsed = run( 0, ops, [&]( const uint64_t i ) {
+            sx::native_access::get_spot_prices( stats, "swap.sx"_n, bases, { get_symcode( i % keys ), get_symcode( ( i + 1 ) % keys ) } );
+        });
+        report( "prices.pair", keys, ops, elapsed, 0 );
+
+        const uint64_t refreshes = max<uint64_t>( 10, ops * 10 / keys );
+        elapsed = run( 0, refreshes, [&]( const uint64_t i ) {
+            sx::native_access::refresh_spot_prices( stats, "swap.sx"_n, bases );
+        });
+        report( "prices.all", keys, refreshes, elapsed, row_size<sx::stats::prices>( "swap.sx"_n, BASE.raw() ) );
+    }
+    return 0;
+}
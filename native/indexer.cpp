@@ -0,0 +1,215 @@
+// native consumer of stats.sx action traces, rebuilding every table off-chain with the contract code itself
+//
+// usage: ./indexer [--snapshot blocks=7200] [--dir snapshots] [--bases USDT] [--candles 0] [--from block] [--to block] < traces.tsv
+//
+// streams action traces (`traces.hpp`) from stdin, as written by `scripts/traces.sh` from a local nodeos:
+//
+//   ./scripts/traces.sh --follow | ./build/native/indexer --snapshot 600 --dir snapshots
+//
+// each trace runs the contract action in full mode (`swaplogs`, `tradelogs`, `gatewaylogs`, `on_flashlog`) against
+// in-memory tables at the trace timestamp, `tokens` & flashlog reserves update the swap.sx & vaults.sx tables read by
+// the contract, so `config.minimal` deployments can leave rolling buckets, traders, twap, candles, activity & sizes to it
+//
+// every `snapshot` blocks (and at end of input) rows of every table are written to `<dir>/<block_num>.json`,
+// records failing a check were reverted on chain & are skipped
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+#include <sx.swap/swap.sx.hpp>
+#include <sx.vaults/vaults.sx.hpp>
+
+#include "json.hpp"
+#include "traces.hpp"
+
+using namespace eosio;
+using namespace std;
+using namespace traces;
+using json::to_json;
+
+namespace {
+
+// swap.sx `tokens` & vaults.sx `vault` rows read by spot prices & `on_flashlog`
+void set_reserves( const tokens_record & record )
+{
+    sx::swap::tokens _tokens( record.contract, record.contract.value );
+    for ( const asset reserve : record.reserves ) {
+        const auto insert = [&]( auto & row ) {
+            row.sym = reserve.symbol;
+            row.balance = reserve;
+            row.depth = reserve;
+            row.reserve = reserve;
+        };
+        auto itr = _tokens.find( reserve.symbol.code().raw() );
+        if ( itr == _tokens.end() ) _tokens.emplace( record.contract, insert );
+        else _tokens.modify( itr, same_payer, insert );
+    }
+}
+
+void set_deposit( const asset reserve )
+{
+    sx::vaults::vault_table _vault( "vaults.sx"_n, "vaults.sx"_n.value );
+    const auto insert = [&]( auto & row ) {
+        row.id = extended_symbol{ reserve.symbol, {} };
+        row.deposit = extended_asset{ reserve, {} };
+    };
+    auto itr = _vault.find( reserve.symbol.code().raw() );
+    if ( itr == _vault.end() ) _vault.emplace( "vaults.sx"_n, insert );
+    else _vault.modify( itr, same_payer, insert );
+}
+
+void execute( sx::stats & stats, const trace & t )
+{
+    mock::set_time( t.timestamp.sec_since_epoch() );
+
+    if ( auto r = get_if<sx::stats::swaplog_record>( &t.log ) ) stats.swaplogs( { *r } );
+    else if ( auto r = get_if<sx::stats::tradelog_record>( &t.log ) ) stats.tradelogs( { *r } );
+    else if ( auto r = get_if<sx::stats::gatewaylog_record>( &t.log ) ) stats.gatewaylogs( { *r } );
+    else if ( auto r = get_if<sx::stats::flashlog_record>( &t.log ) ) {
+        set_deposit( r->reserve );
+        stats.on_flashlog( r->contract, {}, extended_asset{ r->borrow, {} }, r->fee );
+    }
+    else if ( auto r = get_if<tokens_record>( &t.log ) ) set_reserves( *r );
+}
+
+// snapshot, rows of a table scope as a JSON array
+template <typename T>
+string rows_json( const name scope )
+{
+    T _table( "stats.sx"_n, scope.value );
+    string json = "[";
+    for ( const auto & row : _table ) json += ( json.size() > 1 ? "," : "" ) + to_json( row );
+    return json + "]";
+}
+
+// tables scoped by contract, empty tables left out
+string contract_json( const name contract )
+{
+    const vector<pair<string, string>> tables = {
+        { "prices", rows_json<sx::stats::prices>( contract ) },
+        { "volume.h", rows_json<sx::stats::volume_hourly>( contract ) },
+        { "volume.d", rows_json<sx::stats::volume_daily>( contract ) },
+        { "trades.h", rows_json<sx::stats::trades_hourly>( contract ) },
+        { "trades.d", rows_json<sx::stats::trades_daily>( contract ) },
+        { "gateway.h", rows_json<sx::stats::gateway_hourly>( contract ) },
+        { "gateway.d", rows_json<sx::stats::gateway_daily>( contract ) },
+        { "traders.d", rows_json<sx::stats::traders_daily>( contract ) },
+        { "twap", rows_json<sx::stats::twap>( contract ) },
+        { "candles.m", rows_json<sx::stats::candles_minute>( contract ) },
+        { "candles.h", rows_json<sx::stats::candles_hourly>( contract ) },
+        { "candles.d", rows_json<sx::stats::candles_daily>( contract ) },
+        { "sizes", rows_json<sx::stats::sizes>( contract ) },
+    };
+    string json = "{";
+    for ( const auto & [ table, rows ] : tables ) {
+        if ( rows != "[]" ) json += ( json.size() > 1 ? ",\"" : "\"" ) + table + "\":" + rows;
+    }
+    return json + "}";
+}
+
+// `<dir>/<block_num>.json`: tables scoped by stats.sx, `activity` by table & `contracts` by contract
+void write_snapshot( const filesystem::path & dir, const uint64_t block_num, const set<name> & contracts )
+{
+    string scopes = "{";
+    for ( const name contract : contracts ) scopes += ( scopes.size() > 1 ? "," : "" ) + to_json( contract ) + ":" + contract_json( contract );
+
+    // written aside then renamed, readers never see a partial snapshot
+    const filesystem::path path = dir / ( to_string( block_num ) + ".json" );
+    const filesystem::path partial = dir / ( to_string( block_num ) + ".json.partial" );
+    {
+        ofstream file( partial );
+        file << "{\"block_num\":" << block_num
+             << ",\"volume.v2\":" << rows_json<sx::stats::volume>( "stats.sx"_n )
+             << ",\"flash.v2\":" << rows_json<sx::stats::flash>( "stats.sx"_n )
+             << ",\"trades.v2\":" << rows_json<sx::stats::trades>( "stats.sx"_n )
+             << ",\"gateway.v2\":" << rows_json<sx::stats::gateway>( "stats.sx"_n )
+             << ",\"traders\":" << rows_json<sx::stats::traders>( "stats.sx"_n )
+             << ",\"activity\":{\"volume.v2\":" << rows_json<sx::stats::activity>( "volume.v2"_n )
+             << ",\"flash.v2\":" << rows_json<sx::stats::activity>( "flash.v2"_n )
+             << ",\"trades.v2\":" << rows_json<sx::stats::activity>( "trades.v2"_n )
+             << ",\"gateway.v2\":" << rows_json<sx::stats::activity>( "gateway.v2"_n ) << "}"
+             << ",\"contracts\":" << scopes << "}}" << endl;
+    }
+    filesystem::rename( partial, path );
+    cerr << "snapshot " << path.string() << endl;
+}
+
+}
+
+int main( int argc, char ** argv )
+{
+    uint64_t interval = 7200;
+    filesystem::path dir = "snapshots";
+    string bases = "USDT";
+    uint32_t candles = 0;
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+
+    for ( int i = 1; i + 1 < argc; i += 2 ) {
+        const string option = argv[i];
+        const string value = argv[ i + 1 ];
+        if ( option == "--snapshot" ) interval = max<uint64_t>( 1, stoull( value ) );
+        else if ( option == "--dir" ) dir = value;
+        else if ( option == "--bases" ) bases = value;
+        else if ( option == "--candles" ) candles = stoul( value );
+        else if ( option == "--from" ) from = stoull( value );
+        else if ( option == "--to" ) to = stoull( value );
+        else {
+            cerr << "unknown option " << option << endl;
+            return 1;
+        }
+    }
+    filesystem::create_directories( dir );
+
+    // full mode, bases & candles as configured on chain (extensions are serialized in order, every one is set)
+    sx::stats stats( "stats.sx"_n, "stats.sx"_n, datastream<const char*>( nullptr, 0 ) );
+    sx::stats::config_row config;
+    config.topk.emplace( 0 );
+    config.candles.emplace( candles );
+    config.bases.emplace();
+    for ( const string & base : split( bases, ',' ) ) config.bases->push_back( symbol_code{ base } );
+    config.throttle.emplace( 0 );
+    config.threshold.emplace( 0 );
+    config.minimal.emplace( false );
+    stats.setconfig( config );
+
+    set<name> contracts;
+    uint64_t last_block = 0;
+    uint64_t applied = 0;
+    uint64_t skipped = 0;
+    string line;
+    for ( uint64_t number = 1; getline( cin, line ); ++number ) {
+        optional<trace> t;
+        try {
+            t = parse_trace( line, number );
+        } catch ( const exception & e ) {
+            cerr << "line " << number << ": skipped, " << e.what() << endl;
+            continue;
+        }
+        if ( !t || t->block_num < from || t->block_num > to ) continue;
+
+        // state as of the end of the last block before the interval boundary
+        if ( last_block && t->block_num / interval > last_block / interval ) write_snapshot( dir, last_block, contracts );
+        last_block = t->block_num;
+
+        try {
+            execute( stats, *t );
+            if ( !holds_alternative<tokens_record>( t->log ) ) contracts.insert( get_contract( t->log ) );
+            applied += 1;
+        } catch ( const check_failure & e ) {
+            cerr << "line " << number << ": skipped, " << e.what() << endl;
+            skipped += 1;
+        }
+    }
+    if ( last_block ) write_snapshot( dir, last_block, contracts );
+
+    cerr << applied << " traces applied, " << skipped << " skipped" << endl;
+    return 0;
+}
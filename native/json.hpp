@@ -0,0 +1,172 @@
+#pragma once
+
+// JSON of contract rows, same layout as the contract ABI (`setrows` action data, indexer snapshots)
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../stats.sx.hpp"
+
+namespace json {
+
+using namespace eosio;
+using namespace std;
+
+inline string to_json( const uint8_t value ) { return to_string( value ); }
+inline string to_json( const uint64_t value ) { return to_string( value ); }
+inline string to_json( const name value ) { return "\"" + value.to_string() + "\""; }
+inline string to_json( const symbol_code value ) { return "\"" + value.to_string() + "\""; }
+inline string to_json( const asset & value ) { return "\"" + value.to_string() + "\""; }
+
+inline string to_json( const time_point_sec value )
+{
+    const time_t seconds = value.sec_since_epoch();
+    char buffer[32];
+    strftime( buffer, sizeof( buffer ), "\"%Y-%m-%dT%H:%M:%S\"", gmtime( &seconds ) );
+    return buffer;
+}
+
+// 128-bit integers as decimal strings, as in the ABI JSON
+inline string to_json( const uint128_t value )
+{
+    string digits;
+    for ( uint128_t v = value; v || digits.empty(); v /= 10 ) digits.insert( digits.begin(), char( '0' + v % 10 ) );
+    return "\"" + digits + "\"";
+}
+
+inline string to_json( const int128_t value )
+{
+    const string digits = to_json( value < 0 ? -uint128_t( value ) : uint128_t( value ) );
+    return value < 0 ? "\"-" + digits.substr( 1 ) : digits;
+}
+
+inline string to_json( const sx::stats::flat_asset & entry )
+{
+    return "{\"symcode\":" + to_json( entry.symcode ) + ",\"precision\":" + to_string( entry.precision ) + ",\"amount\":" + to_string( entry.amount ) + "}";
+}
+
+inline string to_json( const sx::stats::flat_counted_asset & entry )
+{
+    return "{\"symcode\":" + to_json( entry.symcode ) + ",\"precision\":" + to_string( entry.precision ) + ",\"transactions\":" + to_string( entry.transactions ) + ",\"amount\":" + to_string( entry.amount ) + "}";
+}
+
+inline string to_json( const sx::stats::quote_price & quote )
+{
+    return "{\"symcode\":" + to_json( quote.symcode ) + ",\"price\":" + to_json( quote.price ) + "}";
+}
+
+inline string to_json( const sx::stats::checkpoint & entry )
+{
+    return "{\"timestamp\":" + to_json( entry.timestamp ) + ",\"cumulative\":" + to_json( entry.cumulative ) + "}";
+}
+
+// containers after every element overload (not found by argument-dependent lookup)
+template <typename A, typename B>
+string to_json( const pair<A, B> & entry )
+{
+    return "[" + to_json( entry.first ) + "," + to_json( entry.second ) + "]";
+}
+
+template <typename T>
+string to_json( const vector<T> & entries )
+{
+    string json = "[";
+    for ( const T & entry : entries ) json += ( json.size() > 1 ? "," : "" ) + to_json( entry );
+    return json + "]";
+}
+
+template <typename K, typename V>
+string to_json( const map<K, V> & entries )
+{
+    string json = "[";
+    for ( const auto & [ key, value ] : entries ) {
+        json += ( json.size() > 1 ? "," : "" ) + string( "{\"key\":" ) + to_json( key ) + ",\"value\":" + to_json( value ) + "}";
+    }
+    return json + "]";
+}
+
+inline string header( const name contract, const time_point_sec last_modified, const uint64_t transactions )
+{
+    return "{\"contract\":" + to_json( contract ) + ",\"last_modified\":" + to_json( last_modified ) + ",\"transactions\":" + to_string( transactions );
+}
+
+inline string to_json( const sx::stats::volume_row & row )
+{
+    return header( row.contract, row.last_modified, row.transactions ) + ",\"volume\":" + to_json( row.volume ) + ",\"fees\":" + to_json( row.fees ) + "}";
+}
+
+inline string to_json( const sx::stats::flash_row & row )
+{
+    return header( row.contract, row.last_modified, row.transactions ) + ",\"borrow\":" + to_json( row.borrow ) + ",\"fees\":" + to_json( row.fees ) + ",\"reserves\":" + to_json( row.reserves ) + "}";
+}
+
+inline string to_json( const sx::stats::trades_row & row )
+{
+    return header( row.contract, row.last_modified, row.transactions ) + ",\"borrow\":" + to_json( row.borrow ) + ",\"quantities\":" + to_json( row.quantities ) + ",\"symcodes\":" + to_json( row.symcodes ) + ",\"profits\":" + to_json( row.profits ) + "}";
+}
+
+inline string to_json( const sx::stats::gateway_row & row )
+{
+    return header( row.contract, row.last_modified, row.transactions ) + ",\"ins\":" + to_json( row.ins ) + ",\"outs\":" + to_json( row.outs ) + ",\"savings\":" + to_json( row.savings ) + ",\"fees\":" + to_json( row.fees ) + "}";
+}
+
+inline string to_json( const sx::stats::prices_row & row )
+{
+    return "{\"base\":" + to_json( row.base ) + ",\"last_modified\":" + to_json( row.last_modified ) + ",\"quotes\":" + to_json( row.quotes ) + "}";
+}
+
+// tables skipped by `config.minimal`
+inline string bucket( const uint64_t slot, const time_point_sec bucket, const uint64_t transactions )
+{
+    return "{\"slot\":" + to_string( slot ) + ",\"bucket\":" + to_json( bucket ) + ",\"transactions\":" + to_string( transactions );
+}
+
+inline string to_json( const sx::stats::volume_bucket_row & row )
+{
+    return bucket( row.slot, row.bucket, row.transactions ) + ",\"volume\":" + to_json( row.volume ) + ",\"fees\":" + to_json( row.fees ) + "}";
+}
+
+inline string to_json( const sx::stats::trades_bucket_row & row )
+{
+    return bucket( row.slot, row.bucket, row.transactions ) + ",\"borrow\":" + to_json( row.borrow ) + ",\"quantities\":" + to_json( row.quantities ) + ",\"profits\":" + to_json( row.profits ) + "}";
+}
+
+inline string to_json( const sx::stats::gateway_bucket_row & row )
+{
+    return bucket( row.slot, row.bucket, row.transactions ) + ",\"ins\":" + to_json( row.ins ) + ",\"outs\":" + to_json( row.outs ) + ",\"savings\":" + to_json( row.savings ) + ",\"fees\":" + to_json( row.fees ) + "}";
+}
+
+inline string to_json( const sx::stats::traders_row & row )
+{
+    return "{\"contract\":" + to_json( row.contract ) + ",\"registers\":" + to_json( row.registers ) + "}";
+}
+
+inline string to_json( const sx::stats::traders_bucket_row & row )
+{
+    return bucket( row.slot, row.bucket, row.transactions ) + ",\"registers\":" + to_json( row.registers ) + "}";
+}
+
+inline string to_json( const sx::stats::twap_row & row )
+{
+    return "{\"quote\":" + to_json( row.quote ) + ",\"base\":" + to_json( row.base ) + ",\"last_modified\":" + to_json( row.last_modified ) + ",\"price\":" + to_json( row.price ) + ",\"cumulative\":" + to_json( row.cumulative ) + ",\"checkpoints\":" + to_json( row.checkpoints ) + "}";
+}
+
+inline string to_json( const sx::stats::candle_row & row )
+{
+    return "{\"id\":" + to_string( row.id ) + ",\"quote\":" + to_json( row.quote ) + ",\"start\":" + to_json( row.start ) + ",\"open\":" + to_json( row.open ) + ",\"high\":" + to_json( row.high ) + ",\"low\":" + to_json( row.low ) + ",\"close\":" + to_json( row.close ) + ",\"volume\":" + to_json( row.volume ) + ",\"transactions\":" + to_string( row.transactions ) + "}";
+}
+
+inline string to_json( const sx::stats::activity_row & row )
+{
+    return "{\"contract\":" + to_json( row.contract ) + ",\"last_modified\":" + to_json( row.last_modified ) + "}";
+}
+
+inline string to_json( const sx::stats::sizes_row & row )
+{
+    return "{\"symcode\":" + to_json( row.symcode ) + ",\"precision\":" + to_string( row.precision ) + ",\"buckets\":" + to_json( row.buckets ) + "}";
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "name.hpp"
+
+namespace eosio {
+
+// native builds grant every authority, inline actions & notifications are dropped
+inline void require_auth( name ) {}
+inline bool has_auth( name ) { return true; }
+inline bool is_account( name ) { return true; }
+inline void require_recipient( name ) {}
+
+struct permission_level {
+    name actor;
+    name permission;
+};
+
+template <name::raw Name, auto Action>
+struct action_wrapper {
+    action_wrapper( name code, std::vector<permission_level> perms ) {}
+    action_wrapper( name code, permission_level perm ) {}
+
+    template <typename... Args>
+    void send( Args&&... ) const {}
+};
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "check.hpp"
+#include "symbol.hpp"
+
+namespace eosio {
+
+// same checks as the CDT `asset` (symbol match, overflow)
+struct asset {
+    static constexpr int64_t max_amount = ( 1LL << 62 ) - 1;
+
+    int64_t amount = 0;
+    eosio::symbol symbol;
+
+    asset() = default;
+    asset( int64_t a, eosio::symbol s ) : amount( a ), symbol( s ) {
+        check( is_amount_within_range(), "magnitude of asset amount must be less than 2^62" );
+        check( symbol.is_valid(), "invalid symbol name" );
+    }
+
+    bool is_amount_within_range() const { return -max_amount <= amount && amount <= max_amount; }
+    bool is_valid() const { return is_amount_within_range() && symbol.is_valid(); }
+
+    asset operator-() const { return asset{ -amount, symbol }; }
+
+    asset& operator+=( const asset& a ) {
+        check( a.symbol == symbol, "attempt to add asset with different symbol" );
+        amount += a.amount;
+        check( -max_amount <= amount, "addition underflow" );
+        check( amount <= max_amount, "addition overflow" );
+        return *this;
+    }
+
+    asset& operator-=( const asset& a ) {
+        check( a.symbol == symbol, "attempt to subtract asset with different symbol" );
+        amount -= a.amount;
+        check( -max_amount <= amount, "subtraction underflow" );
+        check( amount <= max_amount, "subtraction overflow" );
+        return *this;
+    }
+
+    friend asset operator+( const asset& a, const asset& b ) { asset result = a; result += b; return result; }
+    friend asset operator-( const asset& a, const asset& b ) { asset result = a; result -= b; return result; }
+
+    friend bool operator==( const asset& a, const asset& b ) {
+        check( a.symbol == b.symbol, "comparison of assets with different symbols is not allowed" );
+        return a.amount == b.amount;
+    }
+    friend bool operator!=( const asset& a, const asset& b ) { return !( a == b ); }
+    friend bool operator<( const asset& a, const asset& b ) {
+        check( a.symbol == b.symbol, "comparison of assets with different symbols is not allowed" );
+        return a.amount < b.amount;
+    }
+    friend bool operator<=( const asset& a, const asset& b ) { return !( b < a ); }
+    friend bool operator>( const asset& a, const asset& b ) { return b < a; }
+    friend bool operator>=( const asset& a, const asset& b ) { return !( a < b ); }
+
+    std::string to_string() const {
+        const uint8_t precision = symbol.precision();
+        const bool negative = amount < 0;
+        std::string digits = std::to_string( negative ? -amount : amount );
+        if ( precision ) {
+            if ( digits.size() <= precision ) digits.insert( 0, precision + 1 - digits.size(), '0' );
+            digits.insert( digits.size() - precision, "." );
+        }
+        return ( negative ? "-" : "" ) + digits + " " + symbol.code().to_string();
+    }
+};
+
+struct extended_asset {
+    asset quantity;
+    name contract;
+
+    extended_asset() = default;
+    extended_asset( asset q, name c ) : quantity( q ), contract( c ) {}
+
+    extended_symbol get_extended_symbol() const { return extended_symbol{ quantity.symbol, contract }; }
+};
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+#include <utility>
+
+#include "check.hpp"
+
+namespace eosio {
+
+template <typename T>
+class binary_extension {
+public:
+    constexpr binary_extension() = default;
+    constexpr binary_extension( const T& ext ) : _value( ext ) {}
+    constexpr binary_extension( T&& ext ) : _value( std::move( ext ) ) {}
+
+    constexpr bool has_value() const { return _value.has_value(); }
+
+    constexpr T& value() & {
+        check( has_value(), "cannot get value of empty binary_extension" );
+        return *_value;
+    }
+    constexpr const T& value() const & {
+        check( has_value(), "cannot get value of empty binary_extension" );
+        return *_value;
+    }
+
+    constexpr T value_or() const { return _value.value_or( T{} ); }
+    constexpr T value_or( const T& def ) const { return _value.value_or( def ); }
+
+    constexpr T* operator->() { return &value(); }
+    constexpr const T* operator->() const { return &value(); }
+    constexpr T& operator*() & { return value(); }
+    constexpr const T& operator*() const & { return value(); }
+
+    template <typename... Args>
+    binary_extension& emplace( Args&&... args ) {
+        _value.emplace( std::forward<Args>( args )... );
+        return *this;
+    }
+
+    void reset() { _value.reset(); }
+
+private:
+    std::optional<T> _value;
+};
+
+}
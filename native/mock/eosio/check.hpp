@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace eosio {
+
+// native builds throw instead of aborting the transaction
+struct check_failure : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+inline void check( bool pred, const char* msg ) {
+    if ( !pred ) throw check_failure( msg );
+}
+
+inline void check( bool pred, const std::string& msg ) {
+    if ( !pred ) throw check_failure( msg );
+}
+
+}
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "asset.hpp"
+#include "binary_extension.hpp"
+#include "check.hpp"
+#include "name.hpp"
+#include "symbol.hpp"
+#include "time.hpp"
+
+namespace eosio {
+
+// same binary format as the CDT serializer: little endian integers, varuint32 length prefixes,
+// struct fields in declaration order (read with structured bindings instead of the CDT reflection)
+template <typename T>
+class datastream {
+public:
+    datastream( T start, size_t size ) : _start( start ), _pos( start ), _end( start + size ) {}
+
+    void write( const void* data, size_t size ) {
+        check( size_t( _end - _pos ) >= size, "datastream attempted to write past the end" );
+        std::memcpy( _pos, data, size );
+        _pos += size;
+    }
+
+    void read( void* data, size_t size ) {
+        check( size_t( _end - _pos ) >= size, "datastream attempted to read past the end" );
+        std::memcpy( data, _pos, size );
+        _pos += size;
+    }
+
+    size_t tellp() const { return size_t( _pos - _start ); }
+    size_t remaining() const { return size_t( _end - _pos ); }
+
+private:
+    T _start;
+    T _pos;
+    T _end;
+};
+
+// size only, as `eosio::pack_size`
+template <>
+class datastream<size_t> {
+public:
+    explicit datastream( size_t init_size = 0 ) : _size( init_size ) {}
+
+    void write( const void*, size_t size ) { _size += size; }
+    size_t tellp() const { return _size; }
+
+private:
+    size_t _size;
+};
+
+namespace mock {
+    // aggregate fields (rows & structs of the contract), counted from the widest brace initialization
+    struct any_field {
+        template <typename T>
+        operator T() const;
+    };
+
+    template <typename T, typename = void, typename... Fields>
+    struct is_brace_constructible : std::false_type {};
+
+    template <typename T, typename... Fields>
+    struct is_brace_constructible<T, std::void_t<decltype( T{ std::declval<Fields>()... } )>, Fields...> : std::true_type {};
+
+    template <size_t>
+    using field = any_field;
+
+    template <typename T, size_t... I>
+    constexpr bool has_fields( std::index_sequence<I...> ) { return is_brace_constructible<T, void, field<I>...>::value; }
+
+    template <typename T, size_t N = 12>
+    constexpr size_t field_count() {
+        if constexpr ( N == 0 ) return 0;
+        else if constexpr ( has_fields<T>( std::make_index_sequence<N>{} ) ) return N;
+        else return field_count<T, N - 1>();
+    }
+
+    template <typename T, typename F>
+    void for_each_field( T&& value, F&& f ) {
+        constexpr size_t count = field_count<std::decay_t<T>>();
+        static_assert( count > 0 && count <= 12, "struct must have between 1 and 12 fields to be serialized" );
+        if constexpr ( count == 1 ) { auto&& [ a ] = value; f( a ); }
+        else if constexpr ( count == 2 ) { auto&& [ a, b ] = value; f( a ); f( b ); }
+        else if constexpr ( count == 3 ) { auto&& [ a, b, c ] = value; f( a ); f( b ); f( c ); }
+        else if constexpr ( count == 4 ) { auto&& [ a, b, c, d ] = value; f( a ); f( b ); f( c ); f( d ); }
+        else if constexpr ( count == 5 ) { auto&& [ a, b, c, d, e ] = value; f( a ); f( b ); f( c ); f( d ); f( e ); }
+        else if constexpr ( count == 6 ) { auto&& [ a, b, c, d, e, g ] = value; f( a ); f( b ); f( c ); f( d ); f( e ); f( g ); }
+        else if constexpr ( count == 7 ) { auto&& [ a, b, c, d, e, g, h ] = value; f( a ); f( b ); f( c ); f( d ); f( e ); f( g ); f( h ); }
+        else if constexpr ( count == 8 ) { auto&& [ a, b, c, d, e, g, h, i ] = value; f( a ); f( b ); f( c ); f( d ); f( e ); f( g ); f( h ); f( i ); }
+        else if constexpr ( count == 9 ) { auto&& [ a, b, c, d, e, g, h, i, j ] = value; f( a ); f( b ); f( c ); f( d ); f( e ); f( g ); f( h ); f( i ); f( j ); }
+        else if constexpr ( count == 10 ) { auto&& [ a, b, c, d, e, g, h, i, j, k ] = value; f( a ); f( b ); f( c ); f( d ); f( e ); f( g ); f( h ); f( i ); f( j ); f( k ); }
+        else if constexpr ( count == 11 ) { auto&& [ a, b, c, d, e, g, h, i, j, k, l ] = value; f( a ); f( b ); f( c ); f( d ); f( e ); f( g ); f( h ); f( i ); f( j ); f( k ); f( l ); }
+        else { auto&& [ a, b, c, d, e, g, h, i, j, k, l, m ] = value; f( a ); f( b ); f( c ); f( d ); f( e ); f( g ); f( h ); f( i ); f( j ); f( k ); f( l ); f( m ); }
+    }
+
+    template <typename T>
+    constexpr bool is_scalar_v = std::is_arithmetic_v<T> || std::is_same_v<T, __int128> || std::is_same_v<T, unsigned __int128>;
+
+    template <typename T>
+    constexpr bool is_struct_v = std::is_aggregate_v<T> && std::is_class_v<T>;
+}
+
+// scalars
+template <typename Stream, typename T, std::enable_if_t<mock::is_scalar_v<T>, int> = 0>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const T& value ) { ds.write( &value, sizeof( T ) ); return ds; }
+
+template <typename Stream, typename T, std::enable_if_t<mock::is_scalar_v<T>, int> = 0>
+datastream<Stream>& operator>>( datastream<Stream>& ds, T& value ) { ds.read( &value, sizeof( T ) ); return ds; }
+
+// varuint32 length prefix
+template <typename Stream>
+void write_length( datastream<Stream>& ds, uint64_t length ) {
+    do {
+        uint8_t byte = length & 0x7f;
+        length >>= 7;
+        if ( length ) byte |= 0x80;
+        ds << byte;
+    } while ( length );
+}
+
+template <typename Stream>
+uint64_t read_length( datastream<Stream>& ds ) {
+    uint64_t length = 0;
+    uint8_t byte = 0;
+    uint8_t shift = 0;
+    do {
+        ds >> byte;
+        length |= uint64_t( byte & 0x7f ) << shift;
+        shift += 7;
+    } while ( byte & 0x80 );
+    return length;
+}
+
+// eosio types
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const name value ) { return ds << value.value; }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, name& value ) { return ds >> value.value; }
+
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const symbol_code value ) { return ds << value.raw(); }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, symbol_code& value ) { uint64_t raw; ds >> raw; value = symbol_code{ raw }; return ds; }
+
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const symbol value ) { return ds << value.raw(); }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, symbol& value ) { uint64_t raw; ds >> raw; value = symbol{ raw }; return ds; }
+
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const extended_symbol& value ) { return ds << value.get_symbol() << value.get_contract(); }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, extended_symbol& value ) { symbol sym; name contract; ds >> sym >> contract; value = extended_symbol{ sym, contract }; return ds; }
+
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const asset& value ) { return ds << value.amount << value.symbol; }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, asset& value ) { return ds >> value.amount >> value.symbol; }
+
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const extended_asset& value ) { return ds << value.quantity << value.contract; }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, extended_asset& value ) { return ds >> value.quantity >> value.contract; }
+
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const time_point_sec value ) { return ds << value.utc_seconds; }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, time_point_sec& value ) { return ds >> value.utc_seconds; }
+
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const time_point value ) { return ds << value.elapsed.count(); }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, time_point& value ) { int64_t count; ds >> count; value = time_point( microseconds( count ) ); return ds; }
+
+// binary extensions are only written when set & only read while bytes remain
+template <typename Stream, typename T>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const binary_extension<T>& value ) { if ( value.has_value() ) ds << value.value(); return ds; }
+template <typename Stream, typename T>
+datastream<Stream>& operator>>( datastream<Stream>& ds, binary_extension<T>& value ) {
+    if ( ds.remaining() ) { T v; ds >> v; value.emplace( std::move( v ) ); }
+    return ds;
+}
+
+// std types
+template <typename Stream>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const std::string& value ) { write_length( ds, value.size() ); ds.write( value.data(), value.size() ); return ds; }
+template <typename Stream>
+datastream<Stream>& operator>>( datastream<Stream>& ds, std::string& value ) { value.resize( read_length( ds ) ); ds.read( value.data(), value.size() ); return ds; }
+
+template <typename Stream, typename A, typename B>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const std::pair<A, B>& value ) { return ds << value.first << value.second; }
+template <typename Stream, typename A, typename B>
+datastream<Stream>& operator>>( datastream<Stream>& ds, std::pair<A, B>& value ) { return ds >> value.first >> value.second; }
+
+template <typename Stream, typename T>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const std::optional<T>& value ) {
+    ds << bool( value.has_value() );
+    if ( value ) ds << *value;
+    return ds;
+}
+template <typename Stream, typename T>
+datastream<Stream>& operator>>( datastream<Stream>& ds, std::optional<T>& value ) {
+    bool has_value;
+    ds >> has_value;
+    if ( has_value ) { T v; ds >> v; value = std::move( v ); }
+    else value.reset();
+    return ds;
+}
+
+template <typename Stream, typename T>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const std::vector<T>& value ) {
+    write_length( ds, value.size() );
+    for ( const T& item : value ) ds << item;
+    return ds;
+}
+template <typename Stream, typename T>
+datastream<Stream>& operator>>( datastream<Stream>& ds, std::vector<T>& value ) {
+    value.resize( read_length( ds ) );
+    for ( T& item : value ) ds >> item;
+    return ds;
+}
+
+template <typename Stream, typename K, typename V>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const std::map<K, V>& value ) {
+    write_length( ds, value.size() );
+    for ( const auto& item : value ) ds << item.first << item.second;
+    return ds;
+}
+template <typename Stream, typename K, typename V>
+datastream<Stream>& operator>>( datastream<Stream>& ds, std::map<K, V>& value ) {
+    value.clear();
+    for ( uint64_t length = read_length( ds ); length; --length ) {
+        K key;
+        V item;
+        ds >> key >> item;
+        value.emplace( std::move( key ), std::move( item ) );
+    }
+    return ds;
+}
+
+// structs
+template <typename Stream, typename T, std::enable_if_t<mock::is_struct_v<T>, int> = 0>
+datastream<Stream>& operator<<( datastream<Stream>& ds, const T& value ) {
+    mock::for_each_field( value, [&]( const auto& field ) { ds << field; } );
+    return ds;
+}
+template <typename Stream, typename T, std::enable_if_t<mock::is_struct_v<T>, int> = 0>
+datastream<Stream>& operator>>( datastream<Stream>& ds, T& value ) {
+    mock::for_each_field( value, [&]( auto& field ) { ds >> field; } );
+    return ds;
+}
+
+template <typename T>
+size_t pack_size( const T& value ) {
+    datastream<size_t> ds;
+    ds << value;
+    return ds.tellp();
+}
+
+template <typename T>
+std::vector<char> pack( const T& value ) {
+    std::vector<char> bytes( pack_size( value ) );
+    datastream<char*> ds( bytes.data(), bytes.size() );
+    ds << value;
+    return bytes;
+}
+
+template <typename T>
+T unpack( const char* buffer, size_t length ) {
+    T value{};
+    datastream<const char*> ds( buffer, length );
+    ds >> value;
+    return value;
+}
+
+template <typename T>
+T unpack( const std::vector<char>& bytes ) { return unpack<T>( bytes.data(), bytes.size() ); }
+
+}
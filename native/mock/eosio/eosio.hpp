@@ -0,0 +1,20 @@
+#pragma once
+
+// native stand-in for the CDT headers used by stats.sx, enough to run its code paths off-chain
+
+typedef __int128 int128_t;
+typedef unsigned __int128 uint128_t;
+
+#include "action.hpp"
+#include "asset.hpp"
+#include "binary_extension.hpp"
+#include "check.hpp"
+#include "contract.hpp"
+#include "multi_index.hpp"
+#include "name.hpp"
+#include "symbol.hpp"
+#include "time.hpp"
+
+namespace eosio {
+    static constexpr name same_payer{};
+}
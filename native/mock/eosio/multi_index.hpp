@@ -0,0 +1,258 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+#include "datastream.hpp"
+#include "name.hpp"
+
+namespace eosio {
+
+namespace mock {
+    // tables register a reset so tools can start every run from an empty "chain"
+    inline std::vector<std::function<void()>>& resets() {
+        static std::vector<std::function<void()>> r;
+        return r;
+    }
+
+    inline void reset() {
+        for ( auto& r : resets() ) r();
+    }
+}
+
+template <name::raw IndexName, typename Extractor>
+struct indexed_by {
+    static constexpr name::raw index_name = IndexName;
+    using extractor = Extractor;
+};
+
+template <class Class, typename Type, Type ( Class::*PtrToMemberFunction )() const>
+struct const_mem_fun {
+    using result_type = std::remove_cv_t<std::remove_reference_t<Type>>;
+    result_type operator()( const Class& x ) const { return ( x.*PtrToMemberFunction )(); }
+};
+
+// in-memory `multi_index`: rows are kept packed per (code, scope) in a std::map ordered by primary key,
+// secondary indexes are ordered sets of (secondary key, primary key) kept in sync on every write
+//
+// as the CDT, rows are unpacked on first read into a cache owned by the table object & packed again on every write
+template <name::raw TableName, typename T, typename... Indices>
+class multi_index {
+    template <typename Index>
+    using key_set = std::set<std::pair<typename Index::extractor::result_type, uint64_t>>;
+
+    using bytes = std::vector<char>;
+    using rows_map = std::map<uint64_t, bytes>;
+
+    struct scope_rows {
+        rows_map rows;
+        std::tuple<key_set<Indices>...> indices;
+    };
+
+    using storage = std::map<std::pair<uint64_t, uint64_t>, scope_rows>;
+
+    static storage& tables() {
+        static storage* s = [] {
+            auto* p = new storage();
+            mock::resets().push_back( [p] { p->clear(); } );
+            return p;
+        }();
+        return *s;
+    }
+
+    template <size_t... Is>
+    void insert_keys( const T& row, std::index_sequence<Is...> ) {
+        ( std::get<Is>( _data->indices ).emplace( typename std::tuple_element_t<Is, std::tuple<Indices...>>::extractor()( row ), row.primary_key() ), ... );
+    }
+
+    template <size_t... Is>
+    void erase_keys( const T& row, std::index_sequence<Is...> ) {
+        ( std::get<Is>( _data->indices ).erase( { typename std::tuple_element_t<Is, std::tuple<Indices...>>::extractor()( row ), row.primary_key() } ), ... );
+    }
+
+    template <name::raw IndexName>
+    static constexpr size_t index_position() {
+        constexpr name::raw names[] = { Indices::index_name..., IndexName };
+        size_t i = 0;
+        while ( names[ i ] != IndexName ) ++i;
+        return i;
+    }
+
+    // unpacked rows of this table object
+    const T& load( uint64_t pk ) const {
+        auto& cached = _cache[ pk ];
+        if ( !cached ) cached = std::make_unique<T>( unpack<T>( _data->rows.at( pk ) ) );
+        return *cached;
+    }
+
+    name _code;
+    uint64_t _scope;
+    scope_rows* _data;
+    mutable std::map<uint64_t, std::unique_ptr<T>> _cache;
+
+public:
+    class const_iterator {
+        friend class multi_index;
+        typename rows_map::iterator _itr;
+        const multi_index* _table = nullptr;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+        const_iterator( typename rows_map::iterator itr, const multi_index* table ) : _itr( itr ), _table( table ) {}
+
+        const T& operator*() const { return _table->load( _itr->first ); }
+        const T* operator->() const { return &**this; }
+        const_iterator& operator++() { ++_itr; return *this; }
+        const_iterator& operator--() { --_itr; return *this; }
+        const_iterator operator++( int ) { const_iterator c = *this; ++_itr; return c; }
+        const_iterator operator--( int ) { const_iterator c = *this; --_itr; return c; }
+        bool operator==( const const_iterator& o ) const { return _itr == o._itr; }
+        bool operator!=( const const_iterator& o ) const { return _itr != o._itr; }
+    };
+
+    template <size_t I>
+    class index {
+        using extractor = typename std::tuple_element_t<I, std::tuple<Indices...>>::extractor;
+        using secondary_key = typename extractor::result_type;
+        using set_type = key_set<std::tuple_element_t<I, std::tuple<Indices...>>>;
+
+        multi_index* _table;
+        set_type& keys() const { return std::get<I>( _table->_data->indices ); }
+
+    public:
+        class const_iterator {
+            friend class index;
+            typename set_type::const_iterator _itr;
+            const multi_index* _table;
+
+        public:
+            const_iterator() = default;
+            const_iterator( typename set_type::const_iterator itr, const multi_index* table ) : _itr( itr ), _table( table ) {}
+
+            const T& operator*() const { return _table->load( _itr->second ); }
+            const T* operator->() const { return &**this; }
+            const_iterator& operator++() { ++_itr; return *this; }
+            const_iterator& operator--() { --_itr; return *this; }
+            bool operator==( const const_iterator& o ) const { return _itr == o._itr; }
+            bool operator!=( const const_iterator& o ) const { return _itr != o._itr; }
+        };
+
+        explicit index( multi_index* table ) : _table( table ) {}
+
+        const_iterator begin() const { return { keys().begin(), _table }; }
+        const_iterator end() const { return { keys().end(), _table }; }
+        const_iterator lower_bound( const secondary_key& key ) const { return { keys().lower_bound( { key, 0 } ), _table }; }
+        const_iterator upper_bound( const secondary_key& key ) const { return { keys().upper_bound( { key, UINT64_MAX } ), _table }; }
+
+        const_iterator find( const secondary_key& key ) const {
+            const auto itr = keys().lower_bound( { key, 0 } );
+            if ( itr == keys().end() || itr->first != key ) return end();
+            return { itr, _table };
+        }
+
+        const T& get( const secondary_key& key, const char* error_msg = "unable to find secondary key" ) const {
+            const auto itr = find( key );
+            check( itr != end(), error_msg );
+            return *itr;
+        }
+
+        template <typename Lambda>
+        void modify( const_iterator itr, name payer, Lambda&& updater ) {
+            _table->modify( _table->find( itr._itr->second ), payer, std::forward<Lambda>( updater ) );
+        }
+
+        const_iterator erase( const_iterator itr ) {
+            check( itr != end(), "cannot pass end iterator to erase" );
+            const uint64_t pk = itr._itr->second;
+            const auto next = std::next( itr._itr );
+            _table->erase( _table->find( pk ) );
+            return { next, _table };
+        }
+    };
+
+    multi_index( name code, uint64_t scope ) : _code( code ), _scope( scope ), _data( &tables()[ { code.value, scope } ] ) {}
+
+    static constexpr name table_name() { return name( TableName ); }
+    name get_code() const { return _code; }
+    uint64_t get_scope() const { return _scope; }
+
+    const_iterator begin() const { return const_iterator( _data->rows.begin(), this ); }
+    const_iterator end() const { return const_iterator( _data->rows.end(), this ); }
+    const_iterator find( uint64_t pk ) const { return const_iterator( _data->rows.find( pk ), this ); }
+    const_iterator lower_bound( uint64_t pk ) const { return const_iterator( _data->rows.lower_bound( pk ), this ); }
+    const_iterator upper_bound( uint64_t pk ) const { return const_iterator( _data->rows.upper_bound( pk ), this ); }
+
+    const_iterator require_find( uint64_t pk, const char* error_msg = "unable to find key" ) const {
+        const auto itr = find( pk );
+        check( itr != end(), error_msg );
+        return itr;
+    }
+
+    const T& get( uint64_t pk, const char* error_msg = "unable to find key" ) const { return *require_find( pk, error_msg ); }
+
+    uint64_t available_primary_key() const { return _data->rows.empty() ? 0 : _data->rows.rbegin()->first + 1; }
+
+    template <name::raw IndexName>
+    auto get_index() {
+        constexpr size_t position = index_position<IndexName>();
+        static_assert( position < sizeof...( Indices ), "name not found in indices" );
+        return index<position>( this );
+    }
+
+    template <typename Lambda>
+    const_iterator emplace( name payer, Lambda&& constructor ) {
+        auto row = std::make_unique<T>();
+        constructor( *row );
+        const uint64_t pk = row->primary_key();
+        const auto [ itr, inserted ] = _data->rows.emplace( pk, pack( *row ) );
+        check( inserted, "could not insert object, most likely a uniqueness constraint was violated" );
+        insert_keys( *row, std::index_sequence_for<Indices...>{} );
+        _cache[ pk ] = std::move( row );
+        return const_iterator( itr, this );
+    }
+
+    template <typename Lambda>
+    void modify( const_iterator itr, name payer, Lambda&& updater ) {
+        check( itr != end(), "cannot pass end iterator to modify" );
+        T& row = const_cast<T&>( *itr );
+        const uint64_t pk = row.primary_key();
+        erase_keys( row, std::index_sequence_for<Indices...>{} );
+        updater( row );
+        check( pk == row.primary_key(), "updater cannot change primary key when modifying an object" );
+        insert_keys( row, std::index_sequence_for<Indices...>{} );
+        itr._itr->second = pack( row );
+    }
+
+    template <typename Lambda>
+    void modify( const T& obj, name payer, Lambda&& updater ) {
+        modify( require_find( obj.primary_key(), "object passed to modify is not in multi_index" ), payer, std::forward<Lambda>( updater ) );
+    }
+
+    const_iterator erase( const_iterator itr ) {
+        check( itr != end(), "cannot pass end iterator to erase" );
+        erase_keys( *itr, std::index_sequence_for<Indices...>{} );
+        _cache.erase( itr._itr->first );
+        return const_iterator( _data->rows.erase( itr._itr ), this );
+    }
+
+    void erase( const T& obj ) {
+        erase( require_find( obj.primary_key(), "object passed to erase is not in multi_index" ) );
+    }
+};
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "check.hpp"
+
+namespace eosio {
+
+// same encoding as the CDT `name` (base32, 12 characters + 4 bit 13th)
+struct name {
+    enum class raw : uint64_t {};
+
+    uint64_t value = 0;
+
+    constexpr name() = default;
+    constexpr explicit name( uint64_t v ) : value( v ) {}
+    constexpr name( raw r ) : value( static_cast<uint64_t>( r ) ) {}
+
+    constexpr explicit name( std::string_view str ) {
+        if ( str.size() > 13 ) check( false, "string is too long to be a valid name" );
+        if ( str.empty() ) return;
+
+        const size_t n = str.size() < 12 ? str.size() : 12;
+        for ( size_t i = 0; i < n; ++i ) {
+            value <<= 5;
+            value |= char_to_value( str[ i ] );
+        }
+        value <<= ( 4 + 5 * ( 12 - n ) );
+        if ( str.size() == 13 ) {
+            const uint64_t v = char_to_value( str[ 12 ] );
+            if ( v > 0x0Full ) check( false, "thirteenth character in name cannot be a letter that comes after j" );
+            value |= v;
+        }
+    }
+
+    static constexpr uint8_t char_to_value( char c ) {
+        if ( c == '.' ) return 0;
+        if ( c >= '1' && c <= '5' ) return ( c - '1' ) + 1;
+        if ( c >= 'a' && c <= 'z' ) return ( c - 'a' ) + 6;
+        check( false, "character is not in allowed character set for names" );
+        return 0;
+    }
+
+    constexpr name suffix() const {
+        uint32_t remaining_bits_after_last_actual_dot = 0;
+        uint32_t tmp = 0;
+        for ( int32_t remaining_bits = 59; remaining_bits >= 4; remaining_bits -= 5 ) {
+            const uint64_t c = ( value >> remaining_bits ) & 0x1Full;
+            if ( !c ) tmp = static_cast<uint32_t>( remaining_bits );
+            else remaining_bits_after_last_actual_dot = tmp;
+        }
+
+        const uint64_t thirteenth_character = value & 0x0Full;
+        if ( thirteenth_character ) remaining_bits_after_last_actual_dot = tmp;
+        if ( remaining_bits_after_last_actual_dot == 0 ) return name{ value };
+
+        const uint64_t mask = ( 1ull << remaining_bits_after_last_actual_dot ) - 16;
+        const uint32_t shift = 64 - remaining_bits_after_last_actual_dot;
+        return name{ ( ( value & mask ) << shift ) + ( thirteenth_character << ( shift - 1 ) ) };
+    }
+
+    std::string to_string() const {
+        static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+        std::string str( 13, '.' );
+        uint64_t tmp = value;
+        for ( uint32_t i = 0; i <= 12; ++i ) {
+            str[ 12 - i ] = charmap[ tmp & ( i == 0 ? 0x0f : 0x1f ) ];
+            tmp >>= ( i == 0 ? 4 : 5 );
+        }
+        str.erase( str.find_last_not_of( '.' ) + 1 );
+        return str;
+    }
+
+    constexpr operator raw() const { return raw( value ); }
+    constexpr explicit operator bool() const { return value != 0; }
+
+    friend constexpr bool operator==( const name a, const name b ) { return a.value == b.value; }
+    friend constexpr bool operator!=( const name a, const name b ) { return a.value != b.value; }
+    friend constexpr bool operator<( const name a, const name b ) { return a.value < b.value; }
+};
+
+inline namespace literals {
+    constexpr name operator""_n( const char* s, size_t n ) { return name{ std::string_view{ s, n } }; }
+}
+
+}
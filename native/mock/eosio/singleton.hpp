@@ -0,0 +1,50 @@
+#pragma once
+
+#include "multi_index.hpp"
+
+namespace eosio {
+
+// singleton stored as the single row of a `multi_index` keyed by its own name, as the CDT does
+template <name::raw SingletonName, typename T>
+class singleton {
+    struct row {
+        T value;
+        uint64_t primary_key() const { return static_cast<uint64_t>( SingletonName ); }
+    };
+
+    using table = multi_index<SingletonName, row>;
+
+    static constexpr uint64_t pk_value = static_cast<uint64_t>( SingletonName );
+
+public:
+    singleton( name code, uint64_t scope ) : _t( code, scope ) {}
+
+    bool exists() const { return _t.find( pk_value ) != _t.end(); }
+
+    T get() const {
+        const auto itr = _t.find( pk_value );
+        check( itr != _t.end(), "singleton does not exist" );
+        return itr->value;
+    }
+
+    T get_or_default( const T& def = T() ) const {
+        const auto itr = _t.find( pk_value );
+        return itr != _t.end() ? itr->value : def;
+    }
+
+    void set( const T& value, name bill_to_account ) {
+        const auto itr = _t.find( pk_value );
+        if ( itr != _t.end() ) _t.modify( itr, bill_to_account, [&]( row& r ) { r.value = value; } );
+        else _t.emplace( bill_to_account, [&]( row& r ) { r.value = value; } );
+    }
+
+    void remove() {
+        const auto itr = _t.find( pk_value );
+        if ( itr != _t.end() ) _t.erase( itr );
+    }
+
+private:
+    table _t;
+};
+
+}
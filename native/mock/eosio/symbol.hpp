@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "check.hpp"
+#include "name.hpp"
+
+namespace eosio {
+
+// same encoding as the CDT `symbol_code` (first character in the lowest byte)
+class symbol_code {
+public:
+    constexpr symbol_code() = default;
+    constexpr explicit symbol_code( uint64_t raw ) : value( raw ) {}
+
+    constexpr explicit symbol_code( std::string_view str ) {
+        if ( str.size() > 7 ) check( false, "string is too long to be a valid symbol_code" );
+        for ( auto itr = str.rbegin(); itr != str.rend(); ++itr ) {
+            if ( *itr < 'A' || *itr > 'Z' ) check( false, "only uppercase letters allowed in symbol_code string" );
+            value <<= 8;
+            value |= *itr;
+        }
+    }
+
+    constexpr uint64_t raw() const { return value; }
+    constexpr explicit operator bool() const { return value != 0; }
+
+    constexpr uint32_t length() const {
+        uint64_t sym = value;
+        uint32_t len = 0;
+        while ( sym & 0xFF && len <= 7 ) {
+            ++len;
+            sym >>= 8;
+        }
+        return len;
+    }
+
+    constexpr bool is_valid() const {
+        uint64_t sym = value;
+        for ( int i = 0; i < 7; ++i ) {
+            const char c = static_cast<char>( sym & 0xFF );
+            if ( !( 'A' <= c && c <= 'Z' ) ) return false;
+            sym >>= 8;
+            if ( !( sym & 0xFF ) ) {
+                do {
+                    sym >>= 8;
+                    if ( ( sym & 0xFF ) ) return false;
+                    ++i;
+                } while ( i < 7 );
+            }
+        }
+        return true;
+    }
+
+    std::string to_string() const {
+        std::string str;
+        for ( uint64_t sym = value; sym & 0xFF; sym >>= 8 ) str += static_cast<char>( sym & 0xFF );
+        return str;
+    }
+
+    friend constexpr bool operator==( const symbol_code a, const symbol_code b ) { return a.value == b.value; }
+    friend constexpr bool operator!=( const symbol_code a, const symbol_code b ) { return a.value != b.value; }
+    friend constexpr bool operator<( const symbol_code a, const symbol_code b ) { return a.value < b.value; }
+
+private:
+    uint64_t value = 0;
+};
+
+class symbol {
+public:
+    constexpr symbol() = default;
+    constexpr explicit symbol( uint64_t raw ) : value( raw ) {}
+    constexpr symbol( symbol_code sc, uint8_t precision ) : value( ( sc.raw() << 8 ) | precision ) {}
+    constexpr symbol( std::string_view sc, uint8_t precision ) : symbol( symbol_code{ sc }, precision ) {}
+
+    constexpr bool is_valid() const { return code().is_valid(); }
+    constexpr uint8_t precision() const { return value & 0xFF; }
+    constexpr symbol_code code() const { return symbol_code{ value >> 8 }; }
+    constexpr uint64_t raw() const { return value; }
+    constexpr explicit operator bool() const { return value != 0; }
+
+    friend constexpr bool operator==( const symbol a, const symbol b ) { return a.value == b.value; }
+    friend constexpr bool operator!=( const symbol a, const symbol b ) { return a.value != b.value; }
+    friend constexpr bool operator<( const symbol a, const symbol b ) { return a.value < b.value; }
+
+private:
+    uint64_t value = 0;
+};
+
+class extended_symbol {
+public:
+    constexpr extended_symbol() = default;
+    constexpr extended_symbol( symbol s, name c ) : sym( s ), contract( c ) {}
+
+    constexpr symbol get_symbol() const { return sym; }
+    constexpr name get_contract() const { return contract; }
+
+    friend constexpr bool operator==( const extended_symbol& a, const extended_symbol& b ) { return a.sym == b.sym && a.contract == b.contract; }
+    friend constexpr bool operator!=( const extended_symbol& a, const extended_symbol& b ) { return !( a == b ); }
+
+    symbol sym;
+    name contract;
+};
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+namespace eosio {
+
+class microseconds {
+public:
+    constexpr explicit microseconds( int64_t c = 0 ) : _count( c ) {}
+    constexpr int64_t count() const { return _count; }
+
+    friend constexpr bool operator<( const microseconds a, const microseconds b ) { return a._count < b._count; }
+    friend constexpr bool operator==( const microseconds a, const microseconds b ) { return a._count == b._count; }
+
+private:
+    int64_t _count;
+};
+
+inline constexpr microseconds seconds( int64_t s ) { return microseconds( s * 1000000 ); }
+
+class time_point {
+public:
+    constexpr explicit time_point( microseconds e = microseconds() ) : elapsed( e ) {}
+
+    constexpr const microseconds& time_since_epoch() const { return elapsed; }
+    constexpr uint32_t sec_since_epoch() const { return uint32_t( elapsed.count() / 1000000 ); }
+
+    microseconds elapsed;
+};
+
+class time_point_sec {
+public:
+    constexpr time_point_sec() = default;
+    constexpr explicit time_point_sec( uint32_t seconds ) : utc_seconds( seconds ) {}
+    constexpr time_point_sec( const time_point& t ) : utc_seconds( t.sec_since_epoch() ) {}
+
+    static constexpr time_point_sec maximum() { return time_point_sec( 0xffffffff ); }
+    static constexpr time_point_sec min() { return time_point_sec( 0 ); }
+
+    constexpr uint32_t sec_since_epoch() const { return utc_seconds; }
+
+    friend constexpr bool operator==( const time_point_sec a, const time_point_sec b ) { return a.utc_seconds == b.utc_seconds; }
+    friend constexpr bool operator!=( const time_point_sec a, const time_point_sec b ) { return a.utc_seconds != b.utc_seconds; }
+    friend constexpr bool operator<( const time_point_sec a, const time_point_sec b ) { return a.utc_seconds < b.utc_seconds; }
+    friend constexpr bool operator<=( const time_point_sec a, const time_point_sec b ) { return a.utc_seconds <= b.utc_seconds; }
+    friend constexpr bool operator>( const time_point_sec a, const time_point_sec b ) { return a.utc_seconds > b.utc_seconds; }
+    friend constexpr bool operator>=( const time_point_sec a, const time_point_sec b ) { return a.utc_seconds >= b.utc_seconds; }
+
+    friend constexpr time_point_sec operator+( const time_point_sec t, uint32_t offset ) { return time_point_sec( t.utc_seconds + offset ); }
+    friend constexpr time_point_sec operator-( const time_point_sec t, uint32_t offset ) { return time_point_sec( t.utc_seconds - offset ); }
+
+    uint32_t utc_seconds = 0;
+};
+
+namespace mock {
+    // block time of the native "chain", advanced by the tools
+    inline time_point& now() {
+        static time_point t;
+        return t;
+    }
+
+    inline void set_time( uint32_t sec ) { now() = time_point( seconds( sec ) ); }
+}
+
+inline time_point current_time_point() { return mock::now(); }
+
+}
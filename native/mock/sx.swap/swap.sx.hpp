@@ -0,0 +1,33 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+#include <utility>
+
+// native stand-in for sx.swap: `tokens` table & virtual reserves (amplifier of 1)
+namespace sx {
+namespace swap {
+
+using namespace eosio;
+
+struct tokens_row {
+    symbol      sym;
+    name        contract;
+    asset       balance;
+    asset       depth;
+    asset       reserve;
+
+    uint64_t primary_key() const { return sym.code().raw(); }
+};
+typedef eosio::multi_index<"tokens"_n, tokens_row> tokens;
+
+inline std::pair<asset, asset> get_virtual_reserves( const name contract, const symbol_code symcode_in, const symbol_code symcode_out )
+{
+    tokens _tokens( contract, contract.value );
+    const asset reserve_in = _tokens.get( symcode_in.raw(), "[symcode_in] token does not exist" ).reserve;
+    const asset reserve_out = _tokens.get( symcode_out.raw(), "[symcode_out] token does not exist" ).reserve;
+    return { reserve_in, reserve_out };
+}
+
+}
+}
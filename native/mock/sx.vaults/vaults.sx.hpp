@@ -0,0 +1,24 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+// native stand-in for sx.vaults: `vault` table keyed by deposit symbol code
+namespace sx {
+namespace vaults {
+
+using namespace eosio;
+
+struct vault_row {
+    extended_symbol     id;
+    extended_asset      deposit;
+    extended_asset      staked;
+    extended_asset      supply;
+    name                account;
+    time_point_sec      last_updated;
+
+    uint64_t primary_key() const { return id.get_symbol().code().raw(); }
+};
+typedef eosio::multi_index<"vault"_n, vault_row> vault_table;
+
+}
+}
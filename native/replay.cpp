@@ -0,0 +1,172 @@
+// native replay of recorded log traces into `setrows` batches, using the contract accumulators (`stats.sx.accumulate.hpp`)
+//
+// usage: ./replay [--from block] [--to block] [--threads n] [--batch rows] < traces.tsv > setrows.jsonl
+//
+// input lines are action traces (`traces.hpp`), `tokens` lines are ignored
+//
+// contracts are partitioned across threads, each replaying its contracts in trace order, partial rows are merged
+// and printed as `setrows` action data, at most `batch` rows per line:
+//
+//   while read -r rows; do cleos push action stats.sx setrows "$rows" -p stats.sx; done < setrows.jsonl
+//
+// followed by `rebuild` of each table to refresh totals
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "../stats.sx.accumulate.hpp"
+#include "json.hpp"
+#include "traces.hpp"
+
+using namespace eosio;
+using namespace std;
+using namespace traces;
+using json::to_json;
+
+namespace {
+
+// rows of one partition
+struct rows {
+    map<name, sx::stats::volume_row>    volume;
+    map<name, sx::stats::flash_row>     flash;
+    map<name, sx::stats::trades_row>    trades;
+    map<name, sx::stats::gateway_row>   gateway;
+};
+
+// replay, records failing a check were reverted on chain & are skipped
+template <typename T, typename R>
+void apply( map<name, T> & table, const trace & t, const R & r )
+{
+    T row = table.count( r.contract ) ? table[ r.contract ] : T{ r.contract };
+    accumulate( row, r );
+    row.last_modified = max( row.last_modified, t.timestamp );
+    table[ r.contract ] = row;
+}
+
+void replay( const trace & t, rows & partition )
+{
+    try {
+        const name contract = get_contract( t.log );
+        check( contract.suffix() == "sx"_n, "contract must be *.sx account" );
+        check( contract != "stats.sx"_n, "contract is reserved for totals" );
+
+        if ( auto r = get_if<sx::stats::swaplog_record>( &t.log ) ) apply( partition.volume, t, *r );
+        else if ( auto r = get_if<sx::stats::tradelog_record>( &t.log ) ) apply( partition.trades, t, *r );
+        else if ( auto r = get_if<sx::stats::gatewaylog_record>( &t.log ) ) apply( partition.gateway, t, *r );
+        else if ( auto r = get_if<sx::stats::flashlog_record>( &t.log ) ) apply( partition.flash, t, *r );
+    } catch ( const check_failure & e ) {
+        cerr << "line " << t.line << ": skipped, " << e.what() << endl;
+    }
+}
+
+template <typename T>
+void merge_rows( map<name, T> & rows, const map<name, T> & others )
+{
+    for ( const auto & [ contract, other ] : others ) {
+        auto itr = rows.try_emplace( contract, T{ contract } ).first;
+        merge( itr->second, other );
+    }
+}
+
+// one `setrows` call: [volume, flash, trades, gateway]
+struct batch {
+    vector<string> tables[4];
+    uint64_t size = 0;
+
+    void print()
+    {
+        if ( !size ) return;
+        string json = "[";
+        for ( size_t i = 0; i < 4; ++i ) {
+            json += ( i ? ",[" : "[" );
+            for ( size_t j = 0; j < tables[i].size(); ++j ) json += ( j ? "," : "" ) + tables[i][j];
+            json += "]";
+            tables[i].clear();
+        }
+        cout << json << "]" << endl;
+        size = 0;
+    }
+
+    template <typename T>
+    void add( const size_t table, const map<name, T> & rows, const uint64_t limit )
+    {
+        for ( const auto & [ contract, row ] : rows ) {
+            tables[ table ].push_back( to_json( row ) );
+            if ( ++size >= limit ) print();
+        }
+    }
+};
+
+}
+
+int main( int argc, char ** argv )
+{
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    uint64_t threads = max( 1u, thread::hardware_concurrency() );
+    uint64_t limit = 50;
+
+    for ( int i = 1; i + 1 < argc; i += 2 ) {
+        const string option = argv[i];
+        const uint64_t value = strtoull( argv[ i + 1 ], nullptr, 10 );
+        if ( option == "--from" ) from = value;
+        else if ( option == "--to" ) to = value;
+        else if ( option == "--threads" ) threads = max<uint64_t>( 1, value );
+        else if ( option == "--batch" ) limit = max<uint64_t>( 1, value );
+        else {
+            cerr << "unknown option " << option << endl;
+            return 1;
+        }
+    }
+
+    // traces within block range, in input order
+    vector<trace> traces;
+    string line;
+    for ( uint64_t number = 1; getline( cin, line ); ++number ) {
+        try {
+            const optional<trace> t = parse_trace( line, number );
+            if ( !t || holds_alternative<tokens_record>( t->log ) ) continue;
+            if ( t->block_num < from || t->block_num > to ) continue;
+            traces.push_back( *t );
+        } catch ( const exception & e ) {
+            cerr << "line " << number << ": skipped, " << e.what() << endl;
+        }
+    }
+
+    // partition by contract, every contract is replayed in order by a single thread
+    vector<rows> partitions( threads );
+    vector<thread> workers;
+    for ( uint64_t i = 0; i < threads; ++i ) {
+        workers.emplace_back( [&, i] {
+            for ( const trace & t : traces ) {
+                if ( hash<uint64_t>{}( get_contract( t.log ).value ) % threads == i ) replay( t, partitions[i] );
+            }
+        });
+    }
+    for ( thread & worker : workers ) worker.join();
+
+    rows result;
+    for ( const rows & partition : partitions ) {
+        merge_rows( result.volume, partition.volume );
+        merge_rows( result.flash, partition.flash );
+        merge_rows( result.trades, partition.trades );
+        merge_rows( result.gateway, partition.gateway );
+    }
+
+    batch output;
+    output.add( 0, result.volume, limit );
+    output.add( 1, result.flash, limit );
+    output.add( 2, result.trades, limit );
+    output.add( 3, result.gateway, limit );
+    output.print();
+
+    cerr << traces.size() << " traces, " << result.volume.size() << " volume.v2, " << result.flash.size() << " flash.v2, "
+         << result.trades.size() << " trades.v2, " << result.gateway.size() << " gateway.v2 rows" << endl;
+    return 0;
+}
@@ -0,0 +1,77 @@
+// fixed-point pricing (`div_price`, `div_fixed`) against quotes computed with arbitrary precision integers
+//
+// usage: ./test_prices (also run by `ctest`)
+
+#include <cstdio>
+#include <string>
+
+#include "access.hpp"
+
+using namespace eosio;
+using namespace std;
+
+namespace {
+
+int failures = 0;
+
+string to_string( int128_t value )
+{
+    if ( !value ) return "0";
+    const bool negative = value < 0;
+    string digits;
+    for ( ; value; value /= 10 ) digits.insert( digits.begin(), char( '0' + ( negative ? -( value % 10 ) : value % 10 ) ) );
+    return ( negative ? "-" : "" ) + digits;
+}
+
+int128_t parse( const string & digits )
+{
+    int128_t value = 0;
+    for ( const char c : digits ) value = value * 10 + ( c - '0' );
+    return value;
+}
+
+void expect( const char * name, const int128_t actual, const int128_t expected )
+{
+    if ( actual == expected ) return;
+    printf( "FAIL %s: %s != %s\n", name, to_string( actual ).c_str(), to_string( expected ).c_str() );
+    failures += 1;
+}
+
+asset get_asset( const int64_t amount, const char * symcode, const uint8_t precision ) { return asset{ amount, symbol{ symcode, precision } }; }
+
+}
+
+int main()
+{
+    using sx::native_access;
+    const int128_t UNIT = native_access::PRICE_UNIT;
+    const int128_t MAX = native_access::MAX_PRICE;
+
+    // same precision
+    expect( "USDT/EOS", native_access::div_price( get_asset( 3'0000, "USDT", 4 ), get_asset( 1'0000, "EOS", 4 ) ), 3 * UNIT );
+    expect( "EOS/USDT floor", native_access::div_price( get_asset( 1'0000, "EOS", 4 ), get_asset( 3'0000, "USDT", 4 ) ), parse( "333333333333333333" ) );
+
+    // differing precisions rescaled exactly
+    expect( "USDT,4/BTC,8", native_access::div_price( get_asset( 50000'0000, "USDT", 4 ), get_asset( 1'00000000, "BTC", 8 ) ), 50000 * UNIT );
+    expect( "USDC,6/EOS,4", native_access::div_price( get_asset( 1'000000, "USDC", 6 ), get_asset( 3'0000, "EOS", 4 ) ), parse( "333333333333333333" ) );
+    expect( "A,6/B,2", native_access::div_price( get_asset( 7, "A", 6 ), get_asset( 3, "B", 2 ) ), parse( "233333333333333" ) );
+    expect( "A,4/B,8", native_access::div_price( get_asset( 123456789, "A", 4 ), get_asset( 987654321, "B", 8 ) ), parse( "1249999988609375000142" ) );
+
+    // long division in 18 digit chunks & digit by digit for denominators of 2^63 or more
+    expect( "chunked", native_access::div_fixed( 12345678901234, 98765432109876, 18 ), parse( "124999998860932437" ) );
+    expect( "digit by digit", native_access::div_fixed( int128_t( 1 ) << 64, int128_t( 3 ) << 63, 18 ), parse( "666666666666666666" ) );
+    expect( "negative exponent", native_access::div_fixed( 12345, 1, -2 ), 123 );
+
+    // saturation at `MAX_PRICE` (2^96 - 1)
+    expect( "MAX_PRICE", MAX, parse( "79228162514264337593543950335" ) );
+    expect( "below cap", native_access::div_price( get_asset( 79228162514, "A", 0 ), get_asset( 1, "B", 0 ) ), parse( "79228162514000000000000000000" ) );
+    expect( "above cap", native_access::div_price( get_asset( 79228162515, "A", 0 ), get_asset( 1, "B", 0 ) ), MAX );
+    expect( "max amounts", native_access::div_price( get_asset( asset::max_amount, "A", 0 ), get_asset( 1, "B", 18 ) ), MAX );
+
+    // no reserves
+    expect( "zero numerator", native_access::div_price( get_asset( 0, "A", 4 ), get_asset( 1, "B", 4 ) ), 0 );
+    expect( "zero denominator", native_access::div_price( get_asset( 1, "A", 4 ), get_asset( 0, "B", 4 ) ), 0 );
+
+    printf( "%s\n", failures ? "FAILED" : "OK" );
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+// action traces of native tools (`replay`, `indexer`), one per line, tab separated
+// (lists are comma separated, assets as "1.0000 EOS", extended assets as "1.0000 EOS@eosio.token"):
+//
+//   <block_num> <timestamp> swaplog    <contract> <buyer> <amount_in> <amount_out> <fee>
+//   <block_num> <timestamp> tradelog   <contract> <executor> <borrow> <quantities> <codes> <profit>
+//   <block_num> <timestamp> gatewaylog <contract> <in> <out> <exchanges> <savings> <fee>
+//   <block_num> <timestamp> flashlog   <code> <receiver> <amount> <fee> <reserve>
+//   <block_num> <timestamp> tokens     <contract> <reserves>
+//
+// (`reserve` is the vaults.sx deposit read by `on_flashlog` at that block, `tokens` are the swap contract
+// reserves read by spot prices, written by `scripts/traces.sh`)
+
+#include <cstdio>
+#include <ctime>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "../stats.sx.hpp"
+
+namespace traces {
+
+using namespace eosio;
+using namespace std;
+
+// reserves of a swap contract (`tokens` table)
+struct tokens_record {
+    name            contract;
+    vector<asset>   reserves;
+};
+
+using record = variant<sx::stats::swaplog_record, sx::stats::tradelog_record, sx::stats::gatewaylog_record, sx::stats::flashlog_record, tokens_record>;
+
+struct trace {
+    uint64_t        line;
+    uint64_t        block_num;
+    time_point_sec  timestamp;
+    record          log;
+};
+
+inline vector<string> split( const string & str, const char delimiter )
+{
+    vector<string> parts;
+    if ( str.empty() ) return parts;
+
+    stringstream stream( str );
+    string part;
+    while ( getline( stream, part, delimiter ) ) parts.push_back( part );
+    return parts;
+}
+
+inline asset parse_asset( const string & str )
+{
+    // extended assets ("1.0000 EOS@eosio.token") are read as their quantity
+    const string quantity = str.substr( 0, str.find( '@' ) );
+    const size_t space = quantity.find( ' ' );
+    check( space != string::npos, "asset must be \"<amount> <symbol>\": " + str );
+
+    const string amount = quantity.substr( 0, space );
+    const size_t dot = amount.find( '.' );
+    const uint8_t precision = dot == string::npos ? 0 : amount.size() - dot - 1;
+    string digits = amount;
+    if ( dot != string::npos ) digits.erase( dot, 1 );
+    return asset{ stoll( digits ), symbol{ symbol_code{ quantity.substr( space + 1 ) }, precision } };
+}
+
+inline vector<asset> parse_assets( const string & str )
+{
+    vector<asset> assets;
+    for ( const string & part : split( str, ',' ) ) assets.push_back( parse_asset( part ) );
+    return assets;
+}
+
+inline vector<name> parse_names( const string & str )
+{
+    vector<name> names;
+    for ( const string & part : split( str, ',' ) ) names.push_back( name{ part } );
+    return names;
+}
+
+inline time_point_sec parse_time( const string & str )
+{
+    tm t{};
+    check( sscanf( str.c_str(), "%d-%d-%dT%d:%d:%d", &t.tm_year, &t.tm_mon, &t.tm_mday, &t.tm_hour, &t.tm_min, &t.tm_sec ) == 6, "timestamp must be YYYY-MM-DDThh:mm:ss: " + str );
+    t.tm_year -= 1900;
+    t.tm_mon -= 1;
+    return time_point_sec( timegm( &t ) );
+}
+
+inline record parse_record( const string & action, const vector<string> & f )
+{
+    const auto fields = [&]( const size_t count ) {
+        check( f.size() == count + 3, action + " expects " + to_string( count ) + " fields" );
+    };
+
+    if ( action == "swaplog" ) {
+        fields( 5 );
+        return sx::stats::swaplog_record{ name{ f[3] }, name{ f[4] }, parse_asset( f[5] ), parse_asset( f[6] ), parse_asset( f[7] ) };
+    }
+    if ( action == "tradelog" ) {
+        fields( 6 );
+        return sx::stats::tradelog_record{ name{ f[3] }, name{ f[4] }, parse_asset( f[5] ), parse_assets( f[6] ), parse_names( f[7] ), parse_asset( f[8] ) };
+    }
+    if ( action == "gatewaylog" ) {
+        fields( 6 );
+        return sx::stats::gatewaylog_record{ name{ f[3] }, parse_asset( f[4] ), parse_asset( f[5] ), parse_names( f[6] ), parse_asset( f[7] ), parse_asset( f[8] ) };
+    }
+    if ( action == "flashlog" ) {
+        fields( 5 );
+        return sx::stats::flashlog_record{ name{ f[3] }, parse_asset( f[5] ), parse_asset( f[6] ), parse_asset( f[7] ) };
+    }
+    if ( action == "tokens" ) {
+        fields( 2 );
+        return tokens_record{ name{ f[3] }, parse_assets( f[4] ) };
+    }
+    check( false, "unknown action: " + action );
+    return {};
+}
+
+// blank & `#` lines are skipped (`nullopt`), malformed lines throw
+inline optional<trace> parse_trace( const string & line, const uint64_t number )
+{
+    if ( line.empty() || line[0] == '#' ) return {};
+
+    const vector<string> f = split( line, '\t' );
+    check( f.size() >= 3, "expected <block_num> <timestamp> <action> ..." );
+    return trace{ number, stoull( f[0] ), parse_time( f[1] ), parse_record( f[2], f ) };
+}
+
+inline name get_contract( const record & log )
+{
+    return visit( []( const auto & r ) { return r.contract; }, log );
+}
+
+}
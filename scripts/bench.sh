@@ -0,0 +1,105 @@
+#!/bin/bash
+
+# usage: ./scripts/bench.sh [actions=100] [cardinalities="1 10 100 1000"] [mix=5,2,1,2]
+#
+# for each cardinality (symbols, traders & executors), deploys stats.sx on a fresh local nodeos (./scripts/restart.sh)
+# with stub swap.sx, vaults.sx & flash.sx contracts (./scripts/stubs) holding a reserve for every symbol,
+# then pushes a mix of swaplog, tradelog, gatewaylog & flashlog (weights of mix), recording billed CPU, NET & RAM delta per action
+#
+# stats.sx & stubs are built before the first deploy, against the sx contract headers (`-I ../`, same as ./scripts/build.sh)
+
+ACTIONS=${1:-100}
+CARDINALITIES=${2:-1 10 100 1000}
+MIX=${3:-5,2,1,2}
+REPORT=${REPORT:-bench.csv}
+BATCH=${BATCH:-50}
+KEY=EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV
+
+IFS=, read -r SWAPS TRADES GATEWAYS FLASHES <<< "$MIX"
+TOTAL=$(( SWAPS + TRADES + GATEWAYS + FLASHES ))
+
+# names & symbol codes from index (digits mapped to letters)
+account() { echo "$1$(echo $2 | tr '0-9' 'a-j')"; }
+symcode() { echo "S$(echo $1 | tr '0-9' 'A-J')"; }
+
+ram_usage() { cleos get account stats.sx --json | jq .ram_usage; }
+
+# stats.sx (deployed by ./scripts/restart.sh) & stub contracts
+eosio-cpp stats.sx.cpp -I ../ -o stats.sx.wasm || exit 1
+for stub in swap vaults flash; do
+  eosio-cpp scripts/stubs/$stub.stub.cpp -I ../ -o scripts/stubs/$stub.stub.wasm || exit 1
+done
+
+# reserves of USDT (base) & every symbol, pushed in batches
+set_reserves() {
+  local reserves="{\"quantity\": \"1000000.0000 USDT\", \"contract\": \"token.sx\"}"
+  for (( j = 0; j < $1; j++ )); do
+    reserves="${reserves:+$reserves, }{\"quantity\": \"$(( 1000000 + j )).0000 $(symcode $j)\", \"contract\": \"token.sx\"}"
+    if (( ( j + 1 ) % BATCH == 0 || j + 1 == $1 )); then
+      cleos push action swap.sx setreserves "[[$reserves], 1]" -p swap.sx > /dev/null || exit 1
+      cleos push action vaults.sx setdeposits "[[$reserves]]" -p vaults.sx > /dev/null || exit 1
+      reserves=""
+    fi
+  done
+}
+
+echo "cardinality,action,cpu_us,net_bytes,ram_delta" > $REPORT
+
+for keys in $CARDINALITIES; do
+  # fresh chain with stats.sx & stubs deployed
+  ./scripts/restart.sh
+  sleep 1
+
+  for contract in swap.sx vaults.sx flash.sx basic.sx gateway.sx; do
+    cleos create account eosio $contract $KEY
+  done
+  cleos set contract swap.sx scripts/stubs swap.stub.wasm swap.stub.abi
+  cleos set contract vaults.sx scripts/stubs vaults.stub.wasm vaults.stub.abi
+  cleos set contract flash.sx scripts/stubs flash.stub.wasm flash.stub.abi
+  set_reserves $keys
+
+  for (( i = 0; i < ACTIONS; i++ )); do
+    base=$(symcode $(( i % keys )))
+    quote=$(symcode $(( ( i + 1 ) % keys )))
+    executor=$(account trader $(( i % keys )))
+    amount="$(( 1 + i )).0000"
+    slot=$(( i % TOTAL ))
+
+    if (( slot < SWAPS )); then
+      action=swaplog
+      contract=stats.sx
+      data="[\"swap.sx\", \"$executor\", \"$amount $base\", \"$amount $quote\", \"0.0010 $base\"]"
+      auth=swap.sx
+    elif (( slot < SWAPS + TRADES )); then
+      action=tradelog
+      contract=stats.sx
+      data="[\"basic.sx\", \"$executor\", \"$amount $base\", [\"$amount $base\", \"$amount $quote\"], [\"swap.sx\"], \"0.0001 $base\"]"
+      auth=basic.sx
+    elif (( slot < SWAPS + TRADES + GATEWAYS )); then
+      action=gatewaylog
+      contract=stats.sx
+      data="[\"gateway.sx\", \"$amount $base\", \"$amount $quote\", [\"swap.sx\"], \"0.0000 $quote\", \"0.0000 $quote\"]"
+      auth=gateway.sx
+    else
+      # flash.sx stub notifies stats.sx
+      action=flashlog
+      contract=flash.sx
+      data="[\"basic.sx\", \"$executor\", {\"quantity\": \"$amount $base\", \"contract\": \"token.sx\"}, \"0.0001 $base\"]"
+      auth=flash.sx
+    fi
+
+    before=$(ram_usage)
+    trace=$(cleos push action $contract $action "$data" -p $auth --json 2>/dev/null)
+    after=$(ram_usage)
+
+    if [ -z "$trace" ]; then
+      echo "$action failed: $data" >&2
+      continue
+    fi
+    cpu=$(echo "$trace" | jq .processed.receipt.cpu_usage_us)
+    net=$(echo "$trace" | jq .processed.net_usage)
+    echo "$keys,$action,$cpu,$net,$(( after - before ))" >> $REPORT
+  done
+done
+
+echo "report: $REPORT"
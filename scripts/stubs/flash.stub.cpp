@@ -0,0 +1,18 @@
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+
+using namespace eosio;
+using namespace std;
+
+// bench stand-in for flash.sx: `flashlog` notifies stats.sx like a flash loan would
+class [[eosio::contract("flash.stub")]] flash_stub : public contract {
+public:
+    using contract::contract;
+
+    [[eosio::action]]
+    void flashlog( const name code, const name receiver, const extended_asset amount, const asset fee )
+    {
+        require_auth( get_self() );
+        require_recipient( "stats.sx"_n );
+    }
+};
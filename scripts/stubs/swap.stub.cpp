@@ -0,0 +1,39 @@
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <eosio/singleton.hpp>
+#include <sx.swap/swap.sx.hpp>
+
+using namespace eosio;
+using namespace std;
+
+// bench stand-in for swap.sx: fills `tokens` & `settings` read by stats.sx spot prices
+class [[eosio::contract("swap.stub")]] swap_stub : public contract {
+public:
+    using contract::contract;
+
+    // set reserves of tokens (call in batches for large cardinalities)
+    [[eosio::action]]
+    void setreserves( const vector<extended_asset> reserves, const int64_t amplifier )
+    {
+        require_auth( get_self() );
+
+        sx::swap::settings _settings( get_self(), get_self().value );
+        auto settings = _settings.get_or_default();
+        settings.amplifier = amplifier;
+        _settings.set( settings, get_self() );
+
+        sx::swap::tokens _tokens( get_self(), get_self().value );
+        for ( const extended_asset reserve : reserves ) {
+            const auto insert = [&]( auto & row ) {
+                row.sym = reserve.quantity.symbol;
+                row.contract = reserve.contract;
+                row.balance = reserve.quantity;
+                row.depth = reserve.quantity;
+                row.reserve = reserve.quantity;
+            };
+            auto itr = _tokens.find( reserve.quantity.symbol.code().raw() );
+            if ( itr == _tokens.end() ) _tokens.emplace( get_self(), insert );
+            else _tokens.modify( itr, get_self(), insert );
+        }
+    }
+};
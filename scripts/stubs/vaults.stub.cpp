@@ -0,0 +1,31 @@
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <sx.vaults/vaults.sx.hpp>
+
+using namespace eosio;
+using namespace std;
+
+// bench stand-in for vaults.sx: fills `vault` deposits read by stats.sx on flashlog
+class [[eosio::contract("vaults.stub")]] vaults_stub : public contract {
+public:
+    using contract::contract;
+
+    // set deposits of vaults (call in batches for large cardinalities)
+    [[eosio::action]]
+    void setdeposits( const vector<extended_asset> deposits )
+    {
+        require_auth( get_self() );
+
+        sx::vaults::vault_table _vault( get_self(), get_self().value );
+        for ( const extended_asset deposit : deposits ) {
+            const auto insert = [&]( auto & row ) {
+                row.id = deposit.get_extended_symbol();
+                row.deposit = deposit;
+                row.last_updated = current_time_point();
+            };
+            auto itr = _vault.find( deposit.quantity.symbol.code().raw() );
+            if ( itr == _vault.end() ) _vault.emplace( get_self(), insert );
+            else _vault.modify( itr, get_self(), insert );
+        }
+    }
+};
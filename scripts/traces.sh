@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# usage: ./scripts/traces.sh [pos=0] [--follow] > traces.tsv
+#
+# stats.sx action traces from a local nodeos with the history plugin (`cleos get actions`), written in the format
+# of native/traces.hpp for `native/replay` & `native/indexer`:
+#
+#   ./scripts/traces.sh 0 --follow | ./build/native/indexer --dir snapshots
+#
+# swap contract reserves (`tokens` line before every swaplog) & vaults.sx deposits (flashlog `reserve`) are read
+# when the trace is written, exact only while following head (nodeos keeps no historical table state)
+
+POS=${1:-0}
+FOLLOW=$2
+PAGE=${PAGE:-100}
+
+# one line per record of stats.sx actions & notifications, without reserves
+FORMAT='
+.actions[] | .block_num as $block | .block_time[0:19] as $time
+| .action_trace | select(.receiver == "stats.sx") | .act
+| (.data.contract // .account) as $contract | .data as $d
+| if .name == "swaplog" then [ "swaplog", $contract, $d.buyer, $d.amount_in, $d.amount_out, $d.fee ]
+  elif .name == "swaplogs" then $d.records[] | [ "swaplog", .contract, .buyer, .amount_in, .amount_out, .fee ]
+  elif .name == "tradelog" then [ "tradelog", $contract, $d.executor, $d.borrow, ($d.quantities | join(",")), ($d.codes | join(",")), $d.profit ]
+  elif .name == "tradelogs" then $d.records[] | [ "tradelog", .contract, .executor, .borrow, (.quantities | join(",")), (.codes | join(",")), .profit ]
+  elif .name == "gatewaylog" then [ "gatewaylog", $contract, $d.in, $d.out, ($d.exchanges | join(",")), $d.savings, $d.fee ]
+  elif .name == "gatewaylogs" then $d.records[] | [ "gatewaylog", .contract, .in, .out, (.exchanges | join(",")), .savings, .fee ]
+  elif .name == "flashlog" then [ "flashlog", $d.code, $d.receiver, "\($d.amount.quantity)@\($d.amount.contract)", $d.fee ]
+  else empty end
+| [ $block, $time ] + . | map(tostring) | join("\t")'
+
+# reserves of a swap contract & vaults.sx deposit of a symbol code
+reserves() { cleos get table $1 $1 tokens --limit 1000 | jq -r '[.rows[].reserve] | join(",")'; }
+deposit() { cleos get table vaults.sx vaults.sx vault --limit 1000 | jq -r --arg symcode " $1" '.rows[].deposit.quantity | select(endswith($symcode))'; }
+
+while :; do
+  actions=$(cleos get actions stats.sx $POS $(( PAGE - 1 )) --json) || exit 1
+
+  if [ "$(echo "$actions" | jq '.actions | length')" == "0" ]; then
+    [ "$FOLLOW" == "--follow" ] || break
+    sleep 1
+    continue
+  fi
+
+  echo "$actions" | jq -r "$FORMAT" | while IFS=$'\t' read -r block time action contract fields; do
+    case $action in
+      swaplog)
+        printf '%s\t%s\ttokens\t%s\t%s\n' "$block" "$time" "$contract" "$(reserves $contract)"
+        printf '%s\t%s\t%s\t%s\t%s\n' "$block" "$time" "$action" "$contract" "$fields"
+        ;;
+      flashlog)
+        IFS=$'\t' read -r receiver amount fee <<< "$fields"
+        symcode=${amount#* }
+        printf '%s\t%s\t%s\t%s\t%s\t%s\n' "$block" "$time" "$action" "$contract" "$fields" "$(deposit ${symcode%@*})"
+        ;;
+      *)
+        printf '%s\t%s\t%s\t%s\t%s\n' "$block" "$time" "$action" "$contract" "$fields"
+        ;;
+    esac
+  done
+
+  POS=$(( $(echo "$actions" | jq '.actions[-1].account_action_seq') + 1 ))
+done
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "stats.sx.hpp"
+
+// row updates without table access, shared by `stats.sx` (all-time rows, rolling buckets & totals)
+// and native tools (`native/bench.cpp`, `native/replay.cpp`)
+namespace sx {
+
+// sorted entries
+template <typename T>
+T & get_entry( vector<T> & entries, const symbol sym )
+{
+    auto itr = lower_bound( entries.begin(), entries.end(), sym.code(), []( const T & entry, const symbol_code symcode ) {
+        return entry.symcode < symcode;
+    });
+    if ( itr == entries.end() || itr->symcode != sym.code() ) itr = entries.insert( itr, T{ sym.code(), sym.precision() } );
+    return *itr;
+}
+
+template <typename T>
+const T * find_entry( const vector<T> & entries, const symbol_code symcode )
+{
+    auto itr = lower_bound( entries.begin(), entries.end(), symcode, []( const T & entry, const symbol_code symcode ) {
+        return entry.symcode < symcode;
+    });
+    if ( itr == entries.end() || itr->symcode != symcode ) return nullptr;
+    return &*itr;
+}
+
+// quantities
+inline void add_quantity( map<symbol_code, asset> & quantities, const asset quantity )
+{
+    const auto [ itr, inserted ] = quantities.try_emplace( quantity.symbol.code(), quantity );
+    if ( !inserted ) itr->second += quantity;
+}
+
+inline void try_add_quantity( map<symbol_code, asset> & quantities, const asset quantity )
+{
+    const auto [ itr, inserted ] = quantities.try_emplace( quantity.symbol.code(), quantity );
+
+    // check for exact symbol to avoid failing on OGX,4 vs OGX,8
+    if ( !inserted && itr->second.symbol == quantity.symbol ) itr->second += quantity;
+}
+
+inline void add_counted_quantity( map<symbol_code, pair<uint64_t, asset>> & quantities, const asset quantity )
+{
+    auto & [ count, total ] = quantities.try_emplace( quantity.symbol.code(), 0, asset{ 0, quantity.symbol } ).first->second;
+    count += 1;
+    if ( total.symbol == quantity.symbol ) total += quantity;
+}
+
+inline void add_quantity( vector<stats::flat_asset> & quantities, const asset quantity )
+{
+    stats::flat_asset & entry = get_entry( quantities, quantity.symbol );
+    entry.amount = ( entry.quantity() + quantity ).amount;
+}
+
+inline void try_add_quantity( vector<stats::flat_asset> & quantities, const asset quantity )
+{
+    stats::flat_asset & entry = get_entry( quantities, quantity.symbol );
+
+    // check for exact symbol to avoid failing on OGX,4 vs OGX,8
+    if ( entry.precision == quantity.symbol.precision() ) entry.amount = ( entry.quantity() + quantity ).amount;
+}
+
+inline void add_counted_quantity( vector<stats::flat_counted_asset> & quantities, const asset quantity, const uint64_t transactions = 1 )
+{
+    stats::flat_counted_asset & entry = get_entry( quantities, quantity.symbol );
+    entry.transactions += transactions;
+    if ( entry.precision == quantity.symbol.precision() ) entry.amount = ( entry.quantity() + quantity ).amount;
+}
+
+inline void set_quantity( vector<stats::flat_asset> & quantities, const asset quantity )
+{
+    stats::flat_asset & entry = get_entry( quantities, quantity.symbol );
+    entry.precision = quantity.symbol.precision();
+    entry.amount = quantity.amount;
+}
+
+inline void erase_quantity( vector<stats::flat_asset> & quantities, const symbol_code symcode )
+{
+    const stats::flat_asset * entry = find_entry( quantities, symcode );
+    if ( entry ) quantities.erase( quantities.begin() + ( entry - quantities.data() ) );
+}
+
+inline void add_quantities( vector<stats::flat_asset> & quantities, const vector<stats::flat_asset> & others )
+{
+    for ( const stats::flat_asset & other : others ) {
+        try_add_quantity( quantities, other.quantity() );
+    }
+}
+
+inline void add_counted_quantities( vector<stats::flat_counted_asset> & quantities, const vector<stats::flat_counted_asset> & others )
+{
+    for ( const stats::flat_counted_asset & other : others ) {
+        add_counted_quantity( quantities, other.quantity(), other.transactions );
+    }
+}
+
+// accumulators
+template <typename T>
+void accumulate( T & row, const stats::swaplog_record & record )
+{
+    row.transactions += 1;
+
+    // volume
+    add_quantity( row.volume, record.amount_in );
+    add_quantity( row.volume, record.amount_out );
+
+    // fees
+    add_quantity( row.fees, record.fee );
+}
+
+template <typename T>
+void accumulate( T & row, const stats::flashlog_record & record )
+{
+    row.transactions += 1;
+
+    // reserves (replace with current)
+    set_quantity( row.reserves, record.reserve );
+
+    // fees (add)
+    add_quantity( row.fees, record.fee );
+
+    // borrow (add)
+    add_quantity( row.borrow, record.borrow );
+}
+
+template <typename T>
+void accumulate( T & row, const stats::tradelog_record & record )
+{
+    row.transactions += 1;
+
+    // borrow (add)
+    add_quantity( row.borrow, record.borrow );
+
+    // quantities (add)
+    for ( const asset quantity : record.quantities ) {
+        try_add_quantity( row.quantities, quantity );
+    }
+
+    // profit (add)
+    try_add_quantity( row.profits, record.profit );
+}
+
+// `trades.v2` rows also count transactions per symbol code
+inline void accumulate( stats::trades_row & row, const stats::tradelog_record & record )
+{
+    accumulate<stats::trades_row>( row, record );
+
+    // symcodes (+1)
+    for ( const asset quantity : record.quantities ) {
+        row.symcodes[ quantity.symbol.code() ] += 1;
+    }
+}
+
+template <typename T>
+void accumulate( T & row, const stats::gatewaylog_record & record )
+{
+    row.transactions += 1;
+
+    add_counted_quantity( row.ins, record.in );
+    add_counted_quantity( row.outs, record.out );
+
+    try_add_quantity( row.savings, record.savings );
+    if ( record.fee.amount ) try_add_quantity( row.fees, record.fee );
+}
+
+// merge rows (associative sums, `reserves` are summed as well)
+inline void merge( stats::volume_row & row, const stats::volume_row & other )
+{
+    row.last_modified = max( row.last_modified, other.last_modified );
+    row.transactions += other.transactions;
+    add_quantities( row.volume, other.volume );
+    add_quantities( row.fees, other.fees );
+}
+
+inline void merge( stats::flash_row & row, const stats::flash_row & other )
+{
+    row.last_modified = max( row.last_modified, other.last_modified );
+    row.transactions += other.transactions;
+    add_quantities( row.borrow, other.borrow );
+    add_quantities( row.fees, other.fees );
+    add_quantities( row.reserves, other.reserves );
+}
+
+inline void merge( stats::trades_row & row, const stats::trades_row & other )
+{
+    row.last_modified = max( row.last_modified, other.last_modified );
+    row.transactions += other.transactions;
+    add_quantities( row.borrow, other.borrow );
+    add_quantities( row.quantities, other.quantities );
+    for ( const auto & [ symcode, transactions ] : other.symcodes ) row.symcodes[ symcode ] += transactions;
+    add_quantities( row.profits, other.profits );
+}
+
+inline void merge( stats::gateway_row & row, const stats::gateway_row & other )
+{
+    row.last_modified = max( row.last_modified, other.last_modified );
+    row.transactions += other.transactions;
+    add_counted_quantities( row.ins, other.ins );
+    add_counted_quantities( row.outs, other.outs );
+    add_quantities( row.savings, other.savings );
+    add_quantities( row.fees, other.fees );
+}
+
+}
@@ -1,18 +1,249 @@
 #include <eosio.token/eosio.token.hpp>
 #include <sx.swap/swap.sx.hpp>
 #include <sx.vaults/vaults.sx.hpp>
-#include <sx.utils/utils.hpp>
+
+#include <cmath>
 
 #include "stats.sx.hpp"
+#include "stats.sx.accumulate.hpp"
 
 [[eosio::action]]
 void sx::stats::swaplog( const name contract, const name buyer, const asset amount_in, const asset amount_out, const asset fee )
 {
-    if ( !has_auth("network.sx"_n )) require_auth( contract );
-    check( contract.suffix() == "sx"_n, "contract must be *.sx account");
+    swaplogs( vector<swaplog_record>{ { contract, buyer, amount_in, amount_out, fee } } );
+}
+
+void sx::stats::on_swaplog( const name buyer, const asset amount_in, const asset amount_out, const asset fee )
+{
+    swaplogs( vector<swaplog_record>{ { get_first_receiver(), buyer, amount_in, amount_out, fee } } );
+}
+
+[[eosio::action]]
+void sx::stats::swaplogs( const vector<swaplog_record> records )
+{
+    const config_row config = get_config();
+    const vector<symbol_code> bases = get_bases( config );
+
+    for ( const auto & [ contract, batch ] : group_by_contract( records ) ) {
+        if ( !has_auth("network.sx"_n )) require_auth( contract );
+        check( contract.suffix() == "sx"_n, "contract must be *.sx account");
+        check( contract != get_self(), "contract is reserved for totals");
+
+        set<symbol_code> symcodes;
+        for ( const auto & record : batch ) {
+            symcodes.insert( record.amount_in.symbol.code() );
+            symcodes.insert( record.amount_out.symbol.code() );
+        }
+        vector<name> buyers;
+        for ( const auto & record : batch ) {
+            buyers.push_back( record.buyer );
+        }
+        update_volume( contract, batch, config );
+
+        // minimal mode keeps `*.v2` rows, totals & prices only
+        if ( !config.minimal.value_or() ) update_traders( contract, buyers );
+        else if ( !config.spotprices ) continue;
+
+        // quotes of traded symbols & bases, shared by prices, twap & candles (relative to first base)
+        const map<symbol_code, vector<quote_price>> matrix = get_spot_prices( contract, bases, symcodes );
+        const vector<quote_price> & quotes = matrix.at( bases[0] );
+        if ( config.spotprices ) update_spot_prices( contract, bases, matrix, config );
+        if ( config.minimal.value_or() ) continue;
+
+        // twap & candles are relative to first base, skipped while contract has no reserves of it
+        if ( find_entry( quotes, bases[0] )->price != PRICE_UNIT ) continue;
+        update_twap( contract, bases[0], quotes );
+
+        // candles
+        const uint32_t candles = config.candles.value_or();
+        if ( candles ) {
+            map<symbol_code, asset> volumes;
+            map<symbol_code, uint64_t> transactions;
+            for ( const auto & record : batch ) {
+                for ( const asset quantity : { record.amount_in, record.amount_out } ) {
+                    add_quantity( volumes, quantity );
+                    transactions[ quantity.symbol.code() ] += 1;
+                }
+            }
+            update_candles<sx::stats::candles_minute>( contract, MINUTE, candles, bases[0], quotes, volumes, transactions );
+            update_candles<sx::stats::candles_hourly>( contract, HOUR, candles, bases[0], quotes, volumes, transactions );
+            update_candles<sx::stats::candles_daily>( contract, DAY, candles, bases[0], quotes, volumes, transactions );
+        }
+    }
+}
+
+[[eosio::action]]
+void sx::stats::setconfig( const optional<config_row> config )
+{
+    require_auth( get_self() );
+    sx::stats::config _config( get_self(), get_self().value );
+
+    // clear config
+    if ( !config ) return _config.remove();
+    check( !config->bases.has_value() || config->bases->size(), "bases cannot be empty");
+    _config.set( *config, get_self() );
+}
+
+[[eosio::action, eosio::read_only]]
+vector<sx::stats::quote_price> sx::stats::getprices( const name contract, const symbol_code base )
+{
+    return get_spot_prices( contract, { base }, {} ).at( base );
+}
+
+[[eosio::action, eosio::read_only]]
+sx::stats::totals_result sx::stats::gettotals()
+{
+    sx::stats::volume _volume( get_self(), get_self().value );
+    sx::stats::flash _flash( get_self(), get_self().value );
+    sx::stats::trades _trades( get_self(), get_self().value );
+    sx::stats::gateway _gateway( get_self(), get_self().value );
+
+    // reserved `get_self()` rows
+    totals_result totals{ { get_self() }, { get_self() }, { get_self() }, { get_self() } };
+    auto volume = _volume.find( get_self().value );
+    auto flash = _flash.find( get_self().value );
+    auto trades = _trades.find( get_self().value );
+    auto gateway = _gateway.find( get_self().value );
+
+    if ( volume != _volume.end() ) totals.volume = *volume;
+    if ( flash != _flash.end() ) totals.flash = *flash;
+    if ( trades != _trades.end() ) totals.trades = *trades;
+    if ( gateway != _gateway.end() ) totals.gateway = *gateway;
+    return totals;
+}
+
+[[eosio::action, eosio::read_only]]
+sx::stats::stats_result sx::stats::getstats( const name contract )
+{
+    sx::stats::volume _volume( get_self(), get_self().value );
+    sx::stats::flash _flash( get_self(), get_self().value );
+    sx::stats::prices _prices( get_self(), contract.value );
+    sx::stats::trades _trades( get_self(), get_self().value );
+    sx::stats::gateway _gateway( get_self(), get_self().value );
+
+    stats_result result;
+    auto volume = _volume.find( contract.value );
+    auto flash = _flash.find( contract.value );
+    auto trades = _trades.find( contract.value );
+    auto gateway = _gateway.find( contract.value );
+
+    if ( volume != _volume.end() ) result.volume = *volume;
+    if ( flash != _flash.end() ) result.flash = *flash;
+    for ( const auto & row : _prices ) result.prices.push_back( row );
+    if ( trades != _trades.end() ) result.trades = *trades;
+    if ( gateway != _gateway.end() ) result.gateway = *gateway;
+    return result;
+}
+
+[[eosio::action, eosio::read_only]]
+sx::stats::symbol_result sx::stats::getsymbol( const symbol_code symcode )
+{
+    sx::stats::volume _volume( get_self(), get_self().value );
+    sx::stats::flash _flash( get_self(), get_self().value );
+    sx::stats::trades _trades( get_self(), get_self().value );
+    sx::stats::gateway _gateway( get_self(), get_self().value );
+
+    symbol_result result;
+    for ( volume_row row : _volume ) if ( row.contract != get_self() && filter( row, symcode ) ) result.volume.push_back( row );
+    for ( flash_row row : _flash ) if ( row.contract != get_self() && filter( row, symcode ) ) result.flash.push_back( row );
+    for ( trades_row row : _trades ) if ( row.contract != get_self() && filter( row, symcode ) ) result.trades.push_back( row );
+    for ( gateway_row row : _gateway ) if ( row.contract != get_self() && filter( row, symcode ) ) result.gateway.push_back( row );
+    return result;
+}
+
+[[eosio::action, eosio::read_only]]
+uint64_t sx::stats::gettraders( const name contract, const uint32_t days )
+{
+    // all-time
+    if ( !days ) {
+        sx::stats::traders _traders( get_self(), get_self().value );
+        auto itr = _traders.find( contract.value );
+        return itr != _traders.end() ? estimate_cardinality( itr->registers ) : 0;
+    }
+
+    // union of last daily buckets
+    sx::stats::traders_daily _traders_daily( get_self(), contract.value );
+    const uint32_t now = current_time_point().sec_since_epoch();
+    const time_point_sec since = time_point_sec( now - now % DAY - ( min( days, DAILY_BUCKETS ) - 1 ) * DAY );
+
+    vector<uint8_t> registers;
+    for ( const auto & row : _traders_daily ) {
+        if ( row.bucket >= since ) merge_registers( registers, row.registers );
+    }
+    return estimate_cardinality( registers );
+}
+
+[[eosio::action, eosio::read_only]]
+int128_t sx::stats::gettwap( const name contract, const symbol_code quote, const uint32_t seconds )
+{
+    sx::stats::twap _twap( get_self(), contract.value );
+    const auto & row = _twap.get( quote.raw(), "quote does not exist");
+
+    // extend cumulative to now with last price (wrapping)
+    const uint32_t now = current_time_point().sec_since_epoch();
+    const uint128_t cumulative = row.cumulative + uint128_t( row.price ) * ( now - row.last_modified.sec_since_epoch() );
+
+    // newest checkpoint at or before start of window, window covers at least `seconds`
+    check( seconds && seconds <= now, "seconds must be within 1 and current time");
+    const time_point_sec since = time_point_sec( now - seconds );
+    auto itr = upper_bound( row.checkpoints.begin(), row.checkpoints.end(), since, []( const time_point_sec timestamp, const checkpoint & a ) {
+        return timestamp < a.timestamp;
+    });
+    check( itr != row.checkpoints.begin(), "window starts before oldest checkpoint");
+    --itr;
+
+    // wrapping difference is exact while price × window < 2^128 (`MAX_PRICE` < 2^96, window < 2^32)
+    return int128_t( ( cumulative - itr->cumulative ) / ( now - itr->timestamp.sec_since_epoch() ) );
+}
+
+[[eosio::action, eosio::read_only]]
+sx::stats::sizes_result sx::stats::getsizes( const name contract, const symbol_code symcode )
+{
+    sx::stats::sizes _sizes( get_self(), contract.value );
+    const auto & row = _sizes.get( symcode.raw(), "symcode does not exist");
+
+    const symbol sym = symbol{ symcode, row.precision };
+    uint64_t transactions = 0;
+    for ( const uint64_t count : row.buckets ) transactions += count;
+
+    return sizes_result{
+        transactions,
+        asset{ get_percentile( row.buckets, transactions, 50 ), sym },
+        asset{ get_percentile( row.buckets, transactions, 95 ), sym },
+        asset{ get_percentile( row.buckets, transactions, 99 ), sym }
+    };
+}
+
+[[eosio::action, eosio::read_only]]
+sx::stats::columns_result sx::stats::getcolumns( const name table, const name cursor, const uint32_t limit )
+{
+    if ( table == "volume.v2"_n ) return get_columns<sx::stats::volume>( cursor, limit );
+    if ( table == "flash.v2"_n ) return get_columns<sx::stats::flash>( cursor, limit );
+    if ( table == "trades.v2"_n ) return get_columns<sx::stats::trades>( cursor, limit );
+    if ( table == "gateway.v2"_n ) return get_columns<sx::stats::gateway>( cursor, limit );
+    check( false, "table must be volume.v2, flash.v2, trades.v2 or gateway.v2");
+    return {};
+}
+
+[[eosio::action, eosio::read_only]]
+vector<sx::stats::activity_row> sx::stats::getactive( const name table, const time_point_sec since, const uint32_t limit )
+{
+    sx::stats::activity _activity( get_self(), table.value );
+    auto _bymodified = _activity.get_index<"bymodified"_n>();
 
-    update_volume( contract, vector<asset>{ amount_in, amount_out }, fee );
-    update_spot_prices( contract );
+    vector<activity_row> rows;
+    for ( auto itr = _bymodified.lower_bound( since.sec_since_epoch() ); itr != _bymodified.end() && rows.size() < limit; ++itr ) {
+        rows.push_back( *itr );
+    }
+    return rows;
+}
+
+[[eosio::action]]
+void sx::stats::refresh( const name contract )
+{
+    require_auth( get_self() );
+
+    refresh_spot_prices( contract, get_bases( get_config() ) );
 }
 
 [[eosio::action]]
@@ -24,78 +255,410 @@ void sx::stats::clean( const name contract )
 
     auto itr = _flash.find( contract.value );
     _flash.modify( itr, same_payer, [&]( auto & row ) {
-        row.borrow.erase(symbol_code{"USDT"});
-        row.fees.erase(symbol_code{"USDT"});
-        row.reserves.erase(symbol_code{"USDT"});
+        erase_quantity( row.borrow, symbol_code{"USDT"} );
+        erase_quantity( row.fees, symbol_code{"USDT"} );
+        erase_quantity( row.reserves, symbol_code{"USDT"} );
     });
 }
 
 [[eosio::action]]
-void sx::stats::erase( const name contract )
+void sx::stats::migrate( const name contract, const uint64_t limit )
 {
     require_auth( get_self() );
 
-    sx::stats::volume _volume( get_self(), get_self().value );
+    sx::stats::legacy_volume _legacy_volume( get_self(), get_self().value );
+    sx::stats::legacy_flash _legacy_flash( get_self(), get_self().value );
+    sx::stats::legacy_trades _legacy_trades( get_self(), get_self().value );
+    sx::stats::legacy_gateway _legacy_gateway( get_self(), get_self().value );
     sx::stats::spotprices _spotprices( get_self(), get_self().value );
-    sx::stats::trades _trades( get_self(), get_self().value );
+    map<name, uint64_t> codes;
+    map<name, uint64_t> executors;
+    map<name, uint64_t> exchanges;
+    set<symbol_code> symcodes;
+    uint64_t remaining = limit;
+
+    // drain deprecated counters into scoped tables
+    auto trades = _legacy_trades.find( contract.value );
+    if ( trades != _legacy_trades.end() && ( trades->codes.size() || trades->executors.size() ) ) {
+        _legacy_trades.modify( trades, same_payer, [&]( auto & row ) {
+            remaining -= drain_counters( row.codes, codes, remaining );
+            remaining -= drain_counters( row.executors, executors, remaining );
+        });
+    }
+    auto gateway = _legacy_gateway.find( contract.value );
+    if ( gateway != _legacy_gateway.end() && gateway->exchanges.size() ) {
+        _legacy_gateway.modify( gateway, same_payer, [&]( auto & row ) {
+            remaining -= drain_counters( row.exchanges, exchanges, remaining );
+        });
+    }
+    add_counters<sx::stats::codes>( contract, codes );
+    add_counters<sx::stats::executors>( contract, executors );
+    add_counters<sx::stats::exchanges>( contract, exchanges );
+
+    // merge legacy rows into `*.v2` rows
+    auto volume = _legacy_volume.find( contract.value );
+    if ( remaining && volume != _legacy_volume.end() ) {
+        upsert<sx::stats::volume>( contract, [&]( auto & row ) {
+            row.last_modified = max( row.last_modified, volume->last_modified );
+            row.transactions += volume->transactions;
+            for ( const auto & [ symcode, quantity ] : volume->volume ) add_quantity( row.volume, quantity );
+            for ( const auto & [ symcode, quantity ] : volume->fees ) add_quantity( row.fees, quantity );
+            get_symcodes( row, symcodes );
+        });
+        _legacy_volume.erase( volume );
+        remaining -= 1;
+    }
+    auto flash = _legacy_flash.find( contract.value );
+    if ( remaining && flash != _legacy_flash.end() ) {
+        upsert<sx::stats::flash>( contract, [&]( auto & row ) {
+            row.last_modified = max( row.last_modified, flash->last_modified );
+            row.transactions += flash->transactions;
+            for ( const auto & [ symcode, quantity ] : flash->borrow ) add_quantity( row.borrow, quantity );
+            for ( const auto & [ symcode, quantity ] : flash->fees ) add_quantity( row.fees, quantity );
+
+            // reserves (keep current)
+            for ( const auto & [ symcode, quantity ] : flash->reserves ) {
+                if ( !find_entry( row.reserves, symcode ) ) set_quantity( row.reserves, quantity );
+            }
+            get_symcodes( row, symcodes );
+        });
+        _legacy_flash.erase( flash );
+        remaining -= 1;
+    }
+    if ( remaining && trades != _legacy_trades.end() && trades->codes.empty() && trades->executors.empty() ) {
+        upsert<sx::stats::trades>( contract, [&]( auto & row ) {
+            row.last_modified = max( row.last_modified, trades->last_modified );
+            row.transactions += trades->transactions;
+            for ( const auto & [ symcode, quantity ] : trades->borrow ) add_quantity( row.borrow, quantity );
+            for ( const auto & [ symcode, quantity ] : trades->quantities ) try_add_quantity( row.quantities, quantity );
+            for ( const auto & [ symcode, transactions ] : trades->symcodes ) row.symcodes[ symcode ] += transactions;
+            for ( const auto & [ symcode, quantity ] : trades->profits ) try_add_quantity( row.profits, quantity );
+            get_symcodes( row, symcodes );
+        });
+        _legacy_trades.erase( trades );
+        remaining -= 1;
+    }
+    if ( remaining && gateway != _legacy_gateway.end() && gateway->exchanges.empty() ) {
+        upsert<sx::stats::gateway>( contract, [&]( auto & row ) {
+            row.last_modified = max( row.last_modified, gateway->last_modified );
+            row.transactions += gateway->transactions;
+            for ( const auto & [ symcode, in ] : gateway->ins ) add_counted_quantity( row.ins, in.second, in.first );
+            for ( const auto & [ symcode, out ] : gateway->outs ) add_counted_quantity( row.outs, out.second, out.first );
+            for ( const auto & [ symcode, quantity ] : gateway->savings ) try_add_quantity( row.savings, quantity );
+            for ( const auto & [ symcode, quantity ] : gateway->fees ) try_add_quantity( row.fees, quantity );
+            get_symcodes( row, symcodes );
+        });
+        _legacy_gateway.erase( gateway );
+        remaining -= 1;
+    }
+    add_symbols( symcodes );
 
-    auto volume = _volume.find( contract.value );
     auto spotprices = _spotprices.find( contract.value );
-    auto trades = _trades.find( contract.value );
+    if ( remaining && spotprices != _spotprices.end() ) {
+        _spotprices.erase( spotprices );
+        remaining -= 1;
+    }
+    check( remaining < limit, "no entries available to migrate");
+}
+
+[[eosio::action]]
+name sx::stats::rebuild( const name table, const uint64_t limit )
+{
+    require_auth( get_self() );
+
+    if ( table == "volume.v2"_n ) return rebuild_totals<sx::stats::volume>( table, limit );
+    if ( table == "flash.v2"_n ) return rebuild_totals<sx::stats::flash>( table, limit );
+    if ( table == "trades.v2"_n ) return rebuild_totals<sx::stats::trades>( table, limit );
+    if ( table == "gateway.v2"_n ) return rebuild_totals<sx::stats::gateway>( table, limit );
+    check( false, "table must be volume.v2, flash.v2, trades.v2 or gateway.v2");
+    return {};
+}
+
+[[eosio::action]]
+void sx::stats::setrows( const vector<volume_row> volume, const vector<flash_row> flash, const vector<trades_row> trades, const vector<gateway_row> gateway )
+{
+    require_auth( get_self() );
+    check( volume.size() || flash.size() || trades.size() || gateway.size(), "rows is empty");
+
+    // every row is checked before any is overwritten
+    check_rows( volume );
+    check_rows( flash );
+    check_rows( trades );
+    check_rows( gateway );
+
+    set_rows<sx::stats::volume>( volume );
+    set_rows<sx::stats::flash>( flash );
+    set_rows<sx::stats::trades>( trades );
+    set_rows<sx::stats::gateway>( gateway );
+}
+
+[[eosio::action]]
+void sx::stats::erase( const name contract )
+{
+    require_auth( get_self() );
+
+    uint64_t count = 0;
+    count += erase_row<sx::stats::volume>( contract, 1 );
+    count += erase_row<sx::stats::flash>( contract, 1 );
+    count += erase_row<sx::stats::trades>( contract, 1 );
+    count += erase_row<sx::stats::gateway>( contract, 1 );
+    count += erase_row<sx::stats::legacy_volume>( contract, 1 );
+    count += erase_row<sx::stats::legacy_flash>( contract, 1 );
+    count += erase_row<sx::stats::legacy_trades>( contract, 1 );
+    count += erase_row<sx::stats::legacy_gateway>( contract, 1 );
+    count += erase_row<sx::stats::spotprices>( contract, 1 );
+    check( count, "no contract available to erase");
+}
+
+[[eosio::action]]
+void sx::stats::purge( const name contract, const uint64_t limit )
+{
+    require_auth( get_self() );
+    check( contract != get_self(), "totals are removed with `erase`");
+
+    uint64_t remaining = limit;
+
+    // rows keyed by contract
+    remaining -= erase_row<sx::stats::volume>( contract, remaining );
+    remaining -= erase_row<sx::stats::flash>( contract, remaining );
+    remaining -= erase_row<sx::stats::trades>( contract, remaining );
+    remaining -= erase_row<sx::stats::gateway>( contract, remaining );
+    remaining -= erase_row<sx::stats::legacy_volume>( contract, remaining );
+    remaining -= erase_row<sx::stats::legacy_flash>( contract, remaining );
+    remaining -= erase_row<sx::stats::legacy_trades>( contract, remaining );
+    remaining -= erase_row<sx::stats::legacy_gateway>( contract, remaining );
+    remaining -= erase_row<sx::stats::spotprices>( contract, remaining );
+    remaining -= erase_row<sx::stats::traders>( contract, remaining );
+    remaining -= erase_row<sx::stats::topexecutors>( contract, remaining );
+    remaining -= erase_row<sx::stats::topexchanges>( contract, remaining );
+
+    // activity scoped by table name
+    for ( const name table : { "volume.v2"_n, "flash.v2"_n, "trades.v2"_n, "gateway.v2"_n } ) {
+        sx::stats::activity _activity( get_self(), table.value );
+        auto itr = _activity.find( contract.value );
+        if ( !remaining || itr == _activity.end() ) continue;
+        _activity.erase( itr );
+        remaining -= 1;
+    }
+
+    // tables scoped by contract
+    remaining -= erase_scope<sx::stats::prices>( contract, remaining );
+    remaining -= erase_scope<sx::stats::twap>( contract, remaining );
+    remaining -= erase_scope<sx::stats::volume_hourly>( contract, remaining );
+    remaining -= erase_scope<sx::stats::volume_daily>( contract, remaining );
+    remaining -= erase_scope<sx::stats::trades_hourly>( contract, remaining );
+    remaining -= erase_scope<sx::stats::trades_daily>( contract, remaining );
+    remaining -= erase_scope<sx::stats::gateway_hourly>( contract, remaining );
+    remaining -= erase_scope<sx::stats::gateway_daily>( contract, remaining );
+    remaining -= erase_scope<sx::stats::traders_daily>( contract, remaining );
+    remaining -= erase_scope<sx::stats::executors>( contract, remaining );
+    remaining -= erase_scope<sx::stats::codes>( contract, remaining );
+    remaining -= erase_scope<sx::stats::exchanges>( contract, remaining );
+    remaining -= erase_scope<sx::stats::candles_minute>( contract, remaining );
+    remaining -= erase_scope<sx::stats::candles_hourly>( contract, remaining );
+    remaining -= erase_scope<sx::stats::candles_daily>( contract, remaining );
+    remaining -= erase_scope<sx::stats::sizes>( contract, remaining );
+    check( remaining < limit, "no rows available to purge");
+}
+
+[[eosio::action]]
+name sx::stats::prune( const name table, const name cursor, const int64_t dust, const uint64_t limit )
+{
+    require_auth( get_self() );
+    check( dust >= 0, "dust must be positive");
 
-    check( volume != _volume.end() || spotprices != _spotprices.end() || trades != _trades.end(), "no contract available to erase");
-    if ( volume != _volume.end() ) _volume.erase( volume );
-    if ( spotprices != _spotprices.end() ) _spotprices.erase( spotprices );
-    if ( trades != _trades.end() ) _trades.erase( trades );
+    if ( table == "volume.v2"_n ) return prune_rows<sx::stats::volume>( cursor, dust, limit );
+    if ( table == "flash.v2"_n ) return prune_rows<sx::stats::flash>( cursor, dust, limit );
+    if ( table == "trades.v2"_n ) return prune_rows<sx::stats::trades>( cursor, dust, limit );
+    if ( table == "gateway.v2"_n ) return prune_rows<sx::stats::gateway>( cursor, dust, limit );
+    check( false, "table must be volume.v2, flash.v2, trades.v2 or gateway.v2");
+    return {};
 }
 
-void sx::stats::update_volume( const name contract, const vector<asset> volumes, const asset fee )
+[[eosio::action]]
+void sx::stats::delist( const name contract, const uint64_t limit )
 {
+    require_auth( get_self() );
+
+    sx::swap::tokens _tokens( contract, contract.value );
+    set<symbol_code> listed;
+    for ( const auto & token : _tokens ) listed.insert( token.sym.code() );
+    check( listed.size(), "contract has no tokens");
+
+    const auto is_delisted = [&]( const auto & entry ) {
+        return !listed.count( entry.symcode );
+    };
+    uint64_t remaining = limit;
+
+    // volume entries
     sx::stats::volume _volume( get_self(), get_self().value );
-    auto itr = _volume.find( contract.value );
+    auto volume = _volume.find( contract.value );
+    if ( remaining && volume != _volume.end() ) {
+        volume_row row = *volume;
+        bool modified = erase_entries( row.volume, is_delisted );
+        modified |= erase_entries( row.fees, is_delisted );
+        if ( modified ) {
+            _volume.modify( volume, same_payer, [&]( auto & r ) { r = row; });
+            remaining -= 1;
+        }
+    }
+
+    // prices quotes (whole row of delisted base)
+    sx::stats::prices _prices( get_self(), contract.value );
+    for ( auto itr = _prices.begin(); itr != _prices.end() && remaining; ) {
+        prices_row row = *itr;
+        if ( !listed.count( row.base ) ) {
+            itr = _prices.erase( itr );
+            remaining -= 1;
+            continue;
+        }
+        if ( erase_entries( row.quotes, is_delisted ) ) {
+            _prices.modify( itr, same_payer, [&]( auto & r ) { r = row; });
+            remaining -= 1;
+        }
+        ++itr;
+    }
+
+    // candles of delisted quotes, twap row is erased last & acts as cursor
+    sx::stats::twap _twap( get_self(), contract.value );
+    for ( auto itr = _twap.begin(); itr != _twap.end() && remaining; ) {
+        if ( listed.count( itr->quote ) ) {
+            ++itr;
+            continue;
+        }
+        remaining -= erase_candles<sx::stats::candles_minute>( contract, itr->quote, remaining );
+        remaining -= erase_candles<sx::stats::candles_hourly>( contract, itr->quote, remaining );
+        remaining -= erase_candles<sx::stats::candles_daily>( contract, itr->quote, remaining );
+        if ( !remaining ) break;
+
+        itr = _twap.erase( itr );
+        remaining -= 1;
+    }
+    check( remaining < limit, "no delisted symbols available");
+}
+
+void sx::stats::update_traders( const name contract, const vector<name> & traders )
+{
+    sx::stats::traders _traders( get_self(), get_self().value );
+    auto itr = _traders.find( contract.value );
+
+    const auto insert = [&]( auto & row ) {
+        for ( const name trader : traders ) {
+            add_register( row.registers, trader );
+        }
+    };
+
+    // save table
+    if ( itr == _traders.end() ) {
+        _traders.emplace( get_self(), [&]( auto & row ) {
+            row.contract = contract;
+            insert( row );
+        });
+    } else {
+        _traders.modify( itr, same_payer, insert );
+    }
+
+    // rolling buckets
+    update_bucket<sx::stats::traders_daily>( contract, DAY, DAILY_BUCKETS, [&]( auto & row ) {
+        row.transactions += traders.size();
+        insert( row );
+    });
+}
+
+void sx::stats::add_register( vector<uint8_t> & registers, const name trader )
+{
+    registers.resize( 1 << HLL_PRECISION );
+
+    // splitmix64 finalizer, account names are far from uniform
+    uint64_t hash = trader.value;
+    hash = ( hash ^ ( hash >> 30 ) ) * 0xbf58476d1ce4e5b9;
+    hash = ( hash ^ ( hash >> 27 ) ) * 0x94d049bb133111eb;
+    hash = hash ^ ( hash >> 31 );
 
-    // initial variables
-    map<symbol_code, asset> volume;
-    map<symbol_code, asset> fees;
+    // first bits select register, rank is the position of the first set bit in the rest
+    const uint64_t index = hash >> ( 64 - HLL_PRECISION );
+    const uint64_t rest = hash << HLL_PRECISION;
+    const uint8_t rank = rest ? __builtin_clzll( rest ) + 1 : 64 - HLL_PRECISION + 1;
+    registers[ index ] = max( registers[ index ], rank );
+}
 
-    // append current stats if exists
-    if ( itr != _volume.end() ) {
-        volume = itr->volume;
-        fees = itr->fees;
+void sx::stats::merge_registers( vector<uint8_t> & registers, const vector<uint8_t> & others )
+{
+    registers.resize( 1 << HLL_PRECISION );
+    for ( size_t i = 0; i < others.size() && i < registers.size(); ++i ) {
+        registers[ i ] = max( registers[ i ], others[ i ] );
     }
+}
+
+uint64_t sx::stats::estimate_cardinality( const vector<uint8_t> & registers )
+{
+    if ( registers.empty() ) return 0;
 
-    // volume
-    for ( const asset quantity : volumes ) {
-        if ( volume.find( quantity.symbol.code() ) != volume.end() ) volume[ quantity.symbol.code() ] += quantity;
-        else volume[ quantity.symbol.code() ] = quantity;
+    const double m = registers.size();
+    double sum = 0;
+    uint64_t zeros = 0;
+    for ( const uint8_t rank : registers ) {
+        sum += 1.0 / ( uint64_t(1) << rank );
+        if ( !rank ) zeros += 1;
     }
+    const double estimate = 0.7213 / ( 1 + 1.079 / m ) * m * m / sum;
+
+    // small range correction (linear counting)
+    if ( estimate <= 2.5 * m && zeros ) return llround( m * log( m / zeros ) );
+    return llround( estimate );
+}
+
+void sx::stats::update_volume( const name contract, const vector<swaplog_record> & records, const config_row & config )
+{
+    sx::stats::volume _volume( get_self(), get_self().value );
+    auto itr = _volume.find( contract.value );
 
-    // fees
-    if ( fees.find( fee.symbol.code() ) != fees.end() ) fees[ fee.symbol.code() ] += fee;
-    else fees[ fee.symbol.code() ] = fee;
+    const auto bucket = [&]( auto & row ) {
+        for ( const auto & record : records ) {
+            accumulate( row, record );
+        }
+    };
 
     // save table
     if ( itr == _volume.end() ) {
         _volume.emplace( get_self(), [&]( auto & row ) {
             row.contract = contract;
             row.last_modified = current_time_point();
-            row.transactions = 1;
-            row.volume = volume;
-            row.fees = fees;
+            row.transactions = 0;
+            bucket( row );
         });
     } else {
         _volume.modify( itr, same_payer, [&]( auto & row ) {
             row.last_modified = current_time_point();
-            row.transactions += 1;
-            row.volume = volume;
-            row.fees = fees;
+            bucket( row );
         });
     }
+
+    // totals
+    volume_row delta{};
+    delta.last_modified = current_time_point();
+    bucket( delta );
+    add_totals<sx::stats::volume>( "volume.v2"_n, contract, delta );
+    if ( config.minimal.value_or() ) return;
+    update_activity( "volume.v2"_n, contract );
+
+    // rolling buckets
+    update_bucket<sx::stats::volume_hourly>( contract, HOUR, HOURLY_BUCKETS, bucket );
+    update_bucket<sx::stats::volume_daily>( contract, DAY, DAILY_BUCKETS, bucket );
+
+    // trade sizes
+    vector<asset> quantities;
+    for ( const auto & record : records ) {
+        quantities.push_back( record.amount_in );
+        quantities.push_back( record.amount_out );
+    }
+    update_sizes( contract, quantities );
 }
 
 void sx::stats::on_flashlog( const name code, const name receiver, const extended_asset amount, const asset fee )
 {
     check( code.suffix() == "sx"_n, "code must be *.sx account");
+    check( code != get_self(), "code is reserved for totals");
 
     sx::stats::flash _flash( get_self(), get_self().value );
     sx::vaults::vault_table _vault( "vaults.sx"_n, "vaults.sx"_n.value );
@@ -106,261 +669,1133 @@ void sx::stats::on_flashlog( const name code, const name receiver, const extende
     const asset borrow = amount.quantity;
     const asset reserve = vault->deposit.quantity;
 
-    // initial variables
-    map<symbol_code, asset> _borrow;
-    map<symbol_code, asset> _fees;
-    map<symbol_code, asset> _reserves;
-
-    // append current stats if exists
-    if ( itr != _flash.end() ) {
-        _borrow = itr->borrow;
-        _fees = itr->fees;
-        _reserves = itr->reserves;
-    }
-
-    // reserves (replace with current)
-    _reserves[ reserve.symbol.code() ] = reserve;
-
-    // fees (add)
-    if ( _fees.find( fee.symbol.code() ) != _fees.end() ) _fees[ fee.symbol.code() ] += fee;
-    else _fees[ fee.symbol.code() ] = fee;
+    // previous reserve of contract, totals hold the sum of current reserves
+    const flat_asset * last = itr != _flash.end() ? find_entry( itr->reserves, reserve.symbol.code() ) : nullptr;
+    const int64_t last_reserve = last && last->precision == reserve.symbol.precision() ? last->amount : 0;
 
-    // borrow (add)
-    if ( _borrow.find( borrow.symbol.code() ) != _borrow.end() ) _borrow[ borrow.symbol.code() ] += borrow;
-    else _borrow[ borrow.symbol.code() ] = borrow;
+    const auto insert = [&]( auto & row ) {
+        row.last_modified = current_time_point();
+        accumulate( row, flashlog_record{ code, borrow, fee, reserve } );
+    };
 
     // save table
     if ( itr == _flash.end() ) {
         _flash.emplace( get_self(), [&]( auto & row ) {
             row.contract = code;
-            row.last_modified = current_time_point();
-            row.transactions = 1;
-            row.borrow = _borrow;
-            row.fees = _fees;
-            row.reserves = _reserves;
+            row.transactions = 0;
+            insert( row );
         });
     } else {
-        _flash.modify( itr, same_payer, [&]( auto & row ) {
-            row.last_modified = current_time_point();
-            row.transactions += 1;
-            row.borrow = _borrow;
-            row.fees = _fees;
-            row.reserves = _reserves;
-        });
+        _flash.modify( itr, same_payer, insert );
     }
+
+    // totals
+    flash_row delta{};
+    insert( delta );
+    delta.reserves = { flat_asset{ reserve.symbol.code(), reserve.symbol.precision(), reserve.amount - last_reserve } };
+    add_totals<sx::stats::flash>( "flash.v2"_n, code, delta );
+    if ( !get_config().minimal.value_or() ) update_activity( "flash.v2"_n, code );
 }
 
 [[eosio::action]]
-void sx::stats::tradelog( const name contract, const name executor, const asset borrow, const vector<asset> quantities, const vector<name> codes, const asset profit ) {
-    require_auth( contract );
-    check( contract.suffix() == "sx"_n, "contract must be *.sx account");
+void sx::stats::tradelog( const name contract, const name executor, const asset borrow, const vector<asset> quantities, const vector<name> codes, const asset profit )
+{
+    tradelogs( vector<tradelog_record>{ { contract, executor, borrow, quantities, codes, profit } } );
+}
 
-    sx::stats::trades _trades( get_self(), get_self().value );
-    auto itr = _trades.find( contract.value );
+void sx::stats::on_tradelog( const name executor, const asset borrow, const vector<asset> quantities, const vector<name> codes, const asset profit )
+{
+    tradelogs( vector<tradelog_record>{ { get_first_receiver(), executor, borrow, quantities, codes, profit } } );
+}
 
-    // initial variables
-    map<symbol_code, asset>         _borrow;
-    map<symbol_code, asset>         _quantities;
-    map<name, uint64_t>             _codes;
-    map<symbol_code, uint64_t>      _symcodes;
-    map<name, uint64_t>             _executors;
-    map<symbol_code, asset>         _profits;
+[[eosio::action]]
+void sx::stats::tradelogs( const vector<tradelog_record> records )
+{
+    const config_row config = get_config();
 
-    // append current stats if exists
-    if ( itr != _trades.end() ) {
-        _borrow = itr->borrow;
-        _quantities = itr->quantities;
-        _codes = itr->codes;
-        _symcodes = itr->symcodes;
-        _executors = itr->executors;
-        _profits = itr->profits;
+    for ( const auto & [ contract, batch ] : group_by_contract( records ) ) {
+        require_auth( contract );
+        check( contract.suffix() == "sx"_n, "contract must be *.sx account");
+        check( contract != get_self(), "contract is reserved for totals");
+
+        vector<name> executors;
+        for ( const auto & record : batch ) {
+            executors.push_back( record.executor );
+        }
+        update_trades( contract, batch, config );
+        if ( !config.minimal.value_or() ) update_traders( contract, executors );
     }
+}
 
-    // borrow (add)
-    if ( _borrow.find( borrow.symbol.code() ) != _borrow.end() ) _borrow[ borrow.symbol.code() ] += borrow;
-    else _borrow[ borrow.symbol.code() ] = borrow;
+void sx::stats::update_trades( const name contract, const vector<tradelog_record> & records, const config_row & config )
+{
+    sx::stats::trades _trades( get_self(), get_self().value );
+    auto itr = _trades.find( contract.value );
 
-    for ( const asset quantity : quantities ) {
-        // quantities (add)
-        if ( _quantities.find( quantity.symbol.code() ) != _quantities.end() ) {
-            if(_quantities[ quantity.symbol.code() ].symbol == quantity.symbol)
-                _quantities[ quantity.symbol.code() ] += quantity;
+    // counters of this batch only
+    map<name, uint64_t> codes;
+    map<name, uint64_t> executors;
+    for ( const auto & record : records ) {
+        // codes (+1)
+        for ( const name code : record.codes ) {
+            codes[ code ] += 1;
         }
-        else _quantities[ quantity.symbol.code() ] = quantity;
-
-        // symcodes (+1)
-        _symcodes[ quantity.symbol.code() ] += 1;
-    }
 
-    // codes (+1)
-    for ( const name code : codes ) {
-        _codes[ code ] += 1;
+        // executors (+1)
+        executors[ record.executor ] += 1;
     }
 
-    // executors (+1)
-    _executors[ executor ] += 1;
+    const auto insert = [&]( auto & row ) {
+        row.last_modified = current_time_point();
 
-    // profit (add)
-    if ( _profits.find( profit.symbol.code() ) != _profits.end() ) {
-        if(_profits[ profit.symbol.code() ].symbol == profit.symbol)
-            _profits[ profit.symbol.code() ] += profit;
-    }
-    else _profits[ profit.symbol.code() ] = profit;
+        for ( const auto & record : records ) {
+            accumulate( row, record );
+        }
+    };
 
     // save table
     if ( itr == _trades.end() ) {
         _trades.emplace( get_self(), [&]( auto & row ) {
             row.contract = contract;
-            row.last_modified = current_time_point();
-            row.transactions = 1;
-            row.borrow = _borrow;
-            row.quantities = _quantities;
-            row.codes = _codes;
-            row.symcodes = _symcodes;
-            row.executors = _executors;
-            row.profits = _profits;
+            row.transactions = 0;
+            insert( row );
         });
     } else {
-        _trades.modify( itr, same_payer, [&]( auto & row ) {
-            row.last_modified = current_time_point();
-            row.transactions += 1;
-            row.borrow = _borrow;
-            row.quantities = _quantities;
-            row.codes = _codes;
-            row.symcodes = _symcodes;
-            row.executors = _executors;
-            row.profits = _profits;
-        });
+        _trades.modify( itr, same_payer, insert );
     }
-}
-
 
-[[eosio::action]]
-void sx::stats::gatewaylog(const name contract, const asset in, const asset out, const vector<name> exchanges, const asset savings, const asset fee ) {
-    require_auth( contract );
+    // totals
+    trades_row delta{};
+    insert( delta );
+    add_totals<sx::stats::trades>( "trades.v2"_n, contract, delta );
+    add_counters<sx::stats::codes>( contract, codes );
 
-    check( contract.suffix() == "sx"_n, "contract must be *.sx account");
+    // executors (top K or exact)
+    const uint32_t topk = config.topk.value_or();
+    if ( topk ) add_hitters<sx::stats::topexecutors>( contract, executors, topk );
+    else add_counters<sx::stats::executors>( contract, executors );
 
-    sx::stats::gateway _gateway( get_self(), get_self().value );
-    auto itr = _gateway.find( contract.value );
+    if ( config.minimal.value_or() ) return;
+    update_activity( "trades.v2"_n, contract );
 
-    // initial variables
-    map<symbol_code, pair<uint64_t, asset>> _ins;
-    map<symbol_code, pair<uint64_t, asset>> _outs;
-    map<name, uint64_t>                     _exchanges;
-    map<symbol_code, asset>                 _savings;
-    map<symbol_code, asset>                 _fees;
+    // rolling buckets
+    const auto bucket = [&]( auto & row ) {
+        for ( const auto & record : records ) {
+            accumulate( row, record );
+        }
+    };
+    update_bucket<sx::stats::trades_hourly>( contract, HOUR, HOURLY_BUCKETS, bucket );
+    update_bucket<sx::stats::trades_daily>( contract, DAY, DAILY_BUCKETS, bucket );
 
-    // append current stats if exists
-    if ( itr != _gateway.end() ) {
-        _ins = itr->ins;
-        _outs = itr->outs;
-        _exchanges = itr->exchanges;
-        _savings = itr->savings;
-        _fees = itr->fees;
+    // trade sizes
+    vector<asset> quantities;
+    for ( const auto & record : records ) {
+        quantities.push_back( record.borrow );
     }
+    update_sizes( contract, quantities );
+}
 
-    if(_ins.count(in.symbol.code())) {
-        _ins[in.symbol.code()].first += 1;
-         if(_ins[in.symbol.code()].second.symbol == in.symbol) _ins[in.symbol.code()].second += in;  //check for exact symbol to avoid failing on OGX,4 vs OGX,8
-    }
-    else _ins[in.symbol.code()] = {1, in};
+[[eosio::action]]
+void sx::stats::gatewaylog( const name contract, const asset in, const asset out, const vector<name> exchanges, const asset savings, const asset fee )
+{
+    gatewaylogs( vector<gatewaylog_record>{ { contract, in, out, exchanges, savings, fee } } );
+}
 
-    if(_outs.count(out.symbol.code())) {
-        _outs[out.symbol.code()].first += 1;
-        if(_outs[out.symbol.code()].second.symbol == out.symbol) _outs[out.symbol.code()].second += out;
-    }
-    else _outs[out.symbol.code()] = {1, out};
+void sx::stats::on_gatewaylog( const asset in, const asset out, const vector<name> exchanges, const asset savings, const asset fee )
+{
+    gatewaylogs( vector<gatewaylog_record>{ { get_first_receiver(), in, out, exchanges, savings, fee } } );
+}
 
-    for(const auto& dex: exchanges) {
-        _exchanges[dex] += 1;
-    }
+[[eosio::action]]
+void sx::stats::gatewaylogs( const vector<gatewaylog_record> records )
+{
+    const config_row config = get_config();
+
+    for ( const auto & [ contract, batch ] : group_by_contract( records ) ) {
+        require_auth( contract );
+        check( contract.suffix() == "sx"_n, "contract must be *.sx account");
+        check( contract != get_self(), "contract is reserved for totals");
 
-    if(_savings.count(savings.symbol.code())){
-        if(_savings[ savings.symbol.code() ].symbol == savings.symbol) _savings[ savings.symbol.code() ] += savings;
+        update_gateway( contract, batch, config );
     }
-    else _savings[ savings.symbol.code() ] = savings;
+}
+
+void sx::stats::update_gateway( const name contract, const vector<gatewaylog_record> & records, const config_row & config )
+{
+    sx::stats::gateway _gateway( get_self(), get_self().value );
+    auto itr = _gateway.find( contract.value );
 
-    if(fee.amount) {
-        if(_fees.count(fee.symbol.code())) {
-            if(_fees[ fee.symbol.code() ].symbol == fee.symbol) _fees[ fee.symbol.code() ] += fee;
+    // counters of this batch only
+    map<name, uint64_t> exchanges;
+    for ( const auto & record : records ) {
+        for ( const auto& dex: record.exchanges ) {
+            exchanges[ dex ] += 1;
         }
-        else _fees[ fee.symbol.code() ] = fee;
     }
 
+    const auto insert = [&]( auto & row ) {
+        row.last_modified = current_time_point();
+
+        for ( const auto & record : records ) {
+            accumulate( row, record );
+        }
+    };
+
     // save table
     if ( itr == _gateway.end() ) {
         _gateway.emplace( get_self(), [&]( auto & row ) {
             row.contract = contract;
-            row.last_modified = current_time_point();
-            row.transactions = 1;
-            row.ins = _ins;
-            row.outs = _outs;
-            row.exchanges = _exchanges;
-            row.savings = _savings;
-            row.fees = _fees;
+            row.transactions = 0;
+            insert( row );
         });
     } else {
-        _gateway.modify( itr, same_payer, [&]( auto & row ) {
-            row.last_modified = current_time_point();
-            row.transactions += 1;
-            row.ins = _ins;
-            row.outs = _outs;
-            row.exchanges = _exchanges;
-            row.savings = _savings;
-            row.fees = _fees;
-        });
+        _gateway.modify( itr, same_payer, insert );
     }
 
-}
+    // totals
+    gateway_row delta{};
+    insert( delta );
+    add_totals<sx::stats::gateway>( "gateway.v2"_n, contract, delta );
 
-void sx::stats::update_spot_prices( const name contract )
-{
-    sx::stats::spotprices _spotprices( get_self(), get_self().value );
-    auto itr = _spotprices.find( contract.value );
-    const symbol_code base = symbol_code{"USDT"};
-    const map<symbol_code, double> quotes = get_spot_prices( contract, base );
+    // exchanges (top K or exact)
+    const uint32_t topk = config.topk.value_or();
+    if ( topk ) add_hitters<sx::stats::topexchanges>( contract, exchanges, topk );
+    else add_counters<sx::stats::exchanges>( contract, exchanges );
+
+    if ( config.minimal.value_or() ) return;
+    update_activity( "gateway.v2"_n, contract );
+
+    // rolling buckets
+    const auto bucket = [&]( auto & row ) {
+        for ( const auto & record : records ) {
+            accumulate( row, record );
+        }
+    };
+    update_bucket<sx::stats::gateway_hourly>( contract, HOUR, HOURLY_BUCKETS, bucket );
+    update_bucket<sx::stats::gateway_daily>( contract, DAY, DAILY_BUCKETS, bucket );
+
+    // trade sizes
+    vector<asset> quantities;
+    for ( const auto & record : records ) {
+        quantities.push_back( record.in );
+        quantities.push_back( record.out );
+    }
+    update_sizes( contract, quantities );
+}
+
+template <typename T, typename Updater>
+void sx::stats::upsert( const name contract, const Updater & updater )
+{
+    T _table( get_self(), get_self().value );
+    auto itr = _table.find( contract.value );
+
+    // save table
+    if ( itr == _table.end() ) {
+        _table.emplace( get_self(), [&]( auto & row ) {
+            row.contract = contract;
+            row.transactions = 0;
+            updater( row );
+        });
+    } else {
+        _table.modify( itr, same_payer, updater );
+    }
+}
+
+template <typename T, typename R>
+void sx::stats::add_totals( const name table, const name contract, const R & delta )
+{
+    set<symbol_code> symcodes;
+    get_symcodes( delta, symcodes );
+
+    // pending `rebuild` adds contracts not yet scanned when it reaches them, their symbols are registered now
+    sx::stats::rebuilds _rebuilds( get_self(), get_self().value );
+    auto progress = _rebuilds.find( table.value );
+    if ( progress != _rebuilds.end() && contract.value >= progress->cursor.value ) return add_symbols( symcodes );
+
+    // otherwise symbols already in totals are registered, only entries new to totals need ids
+    bool added = false;
+    upsert<T>( get_self(), [&]( auto & row ) {
+        const size_t entries = count_entries( row );
+        merge( row, delta );
+        added = count_entries( row ) > entries;
+    });
+    if ( added ) add_symbols( symcodes );
+}
+
+template <typename T>
+name sx::stats::rebuild_totals( const name table, const uint64_t limit )
+{
+    T _table( get_self(), get_self().value );
+    sx::stats::rebuilds _rebuilds( get_self(), get_self().value );
+    auto progress = _rebuilds.find( table.value );
+
+    // first call resets totals
+    if ( progress == _rebuilds.end() ) {
+        progress = _rebuilds.emplace( get_self(), [&]( auto & row ) {
+            row.table = table;
+        });
+        upsert<T>( get_self(), [&]( auto & row ) {
+            row = { get_self() };
+        });
+    }
+
+    // sum of contract rows from cursor
+    auto totals = _table.get( get_self().value );
+    set<symbol_code> symcodes;
+    auto itr = _table.lower_bound( progress->cursor.value );
+    for ( uint64_t count = 0; itr != _table.end() && count < limit; ++itr ) {
+        if ( itr->contract == get_self() ) continue;
+        merge( totals, *itr );
+        get_symcodes( *itr, symcodes );
+        count += 1;
+    }
+    add_symbols( symcodes );
+
+    // save table
+    _table.modify( _table.find( get_self().value ), same_payer, [&]( auto & row ) {
+        row = totals;
+    });
+    if ( itr == _table.end() ) {
+        _rebuilds.erase( progress );
+        return {};
+    }
+    _rebuilds.modify( progress, same_payer, [&]( auto & row ) {
+        row.cursor = itr->contract;
+    });
+    return itr->contract;
+}
+
+void sx::stats::update_activity( const name table, const name contract )
+{
+    sx::stats::activity _activity( get_self(), table.value );
+    auto itr = _activity.find( contract.value );
 
     // save table
-    if ( itr == _spotprices.end() ) {
-        _spotprices.emplace(get_self(), [&]( auto & row ) {
+    if ( itr == _activity.end() ) {
+        _activity.emplace( get_self(), [&]( auto & row ) {
             row.contract = contract;
             row.last_modified = current_time_point();
-            row.base = base;
-            row.quotes = quotes;
         });
     } else {
-        _spotprices.modify( itr, same_payer, [&]( auto & row ) {
+        _activity.modify( itr, same_payer, [&]( auto & row ) {
             row.last_modified = current_time_point();
-            row.base = base;
-            row.quotes = quotes;
         });
     }
 }
 
-bool sx::stats::is_token_exists( const name contract, const symbol_code symcode )
+void sx::stats::update_sizes( const name contract, const vector<asset> & quantities )
 {
-    sx::swap::tokens _tokens( contract, contract.value );
-    return _tokens.find( symcode.raw() ) != _tokens.end();
+    sx::stats::sizes _sizes( get_self(), contract.value );
+
+    // histogram of this batch, each row is saved once
+    map<symbol, vector<uint64_t>> batch;
+    for ( const asset quantity : quantities ) {
+        if ( quantity.amount > 0 ) add_size( batch[ quantity.symbol ], quantity.amount );
+    }
+
+    for ( const auto & [ sym, buckets ] : batch ) {
+        auto itr = _sizes.find( sym.code().raw() );
+
+        const auto insert = [&]( auto & row ) {
+            if ( row.buckets.size() < buckets.size() ) row.buckets.resize( buckets.size() );
+            for ( size_t i = 0; i < buckets.size(); ++i ) row.buckets[ i ] += buckets[ i ];
+        };
+
+        // save table
+        if ( itr == _sizes.end() ) {
+            _sizes.emplace( get_self(), [&]( auto & row ) {
+                row.symcode = sym.code();
+                row.precision = sym.precision();
+                insert( row );
+            });
+        } else if ( itr->precision == sym.precision() ) {
+            _sizes.modify( itr, same_payer, insert );
+        }
+    }
+}
+
+void sx::stats::add_size( vector<uint64_t> & buckets, const int64_t amount )
+{
+    // floor(log2(amount))
+    const uint8_t bucket = 63 - __builtin_clzll( amount );
+    if ( buckets.size() <= bucket ) buckets.resize( bucket + 1 );
+    buckets[ bucket ] += 1;
+}
+
+int64_t sx::stats::get_percentile( const vector<uint64_t> & buckets, const uint64_t transactions, const uint8_t percentile )
+{
+    if ( !transactions ) return 0;
+
+    // rank of percentile (1-based), linear interpolation within bucket [2^i, 2^(i+1))
+    const uint64_t rank = ( transactions * percentile + 99 ) / 100;
+    uint64_t cumulative = 0;
+    for ( size_t i = 0; i < buckets.size(); ++i ) {
+        if ( cumulative + buckets[ i ] < rank ) {
+            cumulative += buckets[ i ];
+            continue;
+        }
+        // stay within bucket & within asset range before narrowing
+        const int128_t lower = int128_t( 1 ) << i;
+        const int128_t value = min( lower + lower * ( rank - cumulative ) / buckets[ i ], ( lower << 1 ) - 1 );
+        return min( value, int128_t( asset::max_amount ) );
+    }
+    return 0;
+}
+
+template <typename T>
+uint64_t sx::stats::erase_row( const name contract, const uint64_t limit )
+{
+    T _table( get_self(), get_self().value );
+    auto itr = _table.find( contract.value );
+
+    if ( !limit || itr == _table.end() ) return 0;
+    _table.erase( itr );
+    return 1;
+}
+
+template <typename T>
+uint64_t sx::stats::erase_scope( const name scope, const uint64_t limit )
+{
+    T _table( get_self(), scope.value );
+
+    uint64_t count = 0;
+    for ( auto itr = _table.begin(); itr != _table.end() && count < limit; ++count ) {
+        itr = _table.erase( itr );
+    }
+    return count;
+}
+
+template <typename T>
+uint64_t sx::stats::erase_candles( const name contract, const symbol_code quote, const uint64_t limit )
+{
+    T _candles( get_self(), contract.value );
+    auto _byquote = _candles.template get_index<"byquote"_n>();
+
+    uint64_t count = 0;
+    auto itr = _byquote.lower_bound( candle_key( quote, 0 ) );
+    for ( ; itr != _byquote.end() && itr->quote == quote && count < limit; ++count ) {
+        itr = _byquote.erase( itr );
+    }
+    return count;
+}
+
+template <typename T>
+name sx::stats::prune_rows( const name cursor, const int64_t dust, const uint64_t limit )
+{
+    T _table( get_self(), get_self().value );
+
+    auto itr = _table.lower_bound( cursor.value );
+    for ( uint64_t count = 0; itr != _table.end() && count < limit; ++count, ++itr ) {
+        auto row = *itr;
+        if ( !prune_row( row, dust ) ) continue;
+        _table.modify( itr, same_payer, [&]( auto & r ) { r = row; });
+    }
+    return itr == _table.end() ? name{} : itr->contract;
+}
+
+template <typename T, typename Predicate>
+bool sx::stats::erase_entries( vector<T> & entries, const Predicate & predicate )
+{
+    const size_t size = entries.size();
+    entries.erase( remove_if( entries.begin(), entries.end(), predicate ), entries.end() );
+    return entries.size() != size;
+}
+
+template <typename T, typename R>
+void sx::stats::set_rows( const vector<R> & rows )
+{
+    set<symbol_code> symcodes;
+    for ( const R & other : rows ) {
+        upsert<T>( other.contract, [&]( auto & row ) {
+            row = other;
+        });
+        get_symcodes( other, symcodes );
+    }
+    add_symbols( symcodes );
+}
+
+template <typename R>
+void sx::stats::check_rows( const vector<R> & rows )
+{
+    const uint32_t now = current_time_point().sec_since_epoch();
+    set<name> contracts;
+
+    for ( const R & row : rows ) {
+        check( row.contract != get_self(), "totals are computed with `rebuild`");
+        check( row.contract.suffix() == "sx"_n, "contract must be *.sx account");
+        check( contracts.insert( row.contract ).second, "contract must be unique per table");
+        check( row.last_modified.sec_since_epoch() <= now, "last_modified cannot be in the future");
+        check_row( row );
+    }
+}
+
+template <typename T>
+void sx::stats::check_entries( const vector<T> & entries )
+{
+    for ( size_t i = 0; i < entries.size(); ++i ) {
+        check( entries[ i ].symcode.is_valid(), "invalid symbol code");
+        check( entries[ i ].precision <= 18, "precision must be 18 or less");
+        check( i == 0 || entries[ i - 1 ].symcode < entries[ i ].symcode, "entries must be sorted by symbol code & unique");
+    }
+}
+
+void sx::stats::check_row( const volume_row & row )
+{
+    check_entries( row.volume );
+    check_entries( row.fees );
+}
+
+void sx::stats::check_row( const flash_row & row )
+{
+    check_entries( row.borrow );
+    check_entries( row.fees );
+    check_entries( row.reserves );
+}
+
+void sx::stats::check_row( const trades_row & row )
+{
+    check_entries( row.borrow );
+    check_entries( row.quantities );
+    check_entries( row.profits );
+    for ( const auto & [ symcode, transactions ] : row.symcodes ) {
+        check( symcode.is_valid(), "invalid symbol code");
+    }
+}
+
+void sx::stats::check_row( const gateway_row & row )
+{
+    check_entries( row.ins );
+    check_entries( row.outs );
+    check_entries( row.savings );
+    check_entries( row.fees );
+
+    // each gateway log counts once per `in` & `out` symbol
+    for ( const auto * entries : { &row.ins, &row.outs } ) {
+        for ( const flat_counted_asset & entry : *entries ) {
+            check( entry.transactions <= row.transactions, "symbol transactions cannot exceed row transactions");
+        }
+    }
+}
+
+bool sx::stats::prune_row( volume_row & row, const int64_t dust )
+{
+    const auto is_dust = [&]( const auto & entry ) { return entry.amount >= -dust && entry.amount <= dust; };
+    bool modified = erase_entries( row.volume, is_dust );
+    modified |= erase_entries( row.fees, is_dust );
+    return modified;
+}
+
+bool sx::stats::prune_row( flash_row & row, const int64_t dust )
+{
+    const auto is_dust = [&]( const auto & entry ) { return entry.amount >= -dust && entry.amount <= dust; };
+    bool modified = erase_entries( row.borrow, is_dust );
+    modified |= erase_entries( row.fees, is_dust );
+    modified |= erase_entries( row.reserves, is_dust );
+    return modified;
+}
+
+bool sx::stats::prune_row( trades_row & row, const int64_t dust )
+{
+    const auto is_dust = [&]( const auto & entry ) { return entry.amount >= -dust && entry.amount <= dust; };
+    bool modified = erase_entries( row.borrow, is_dust );
+    modified |= erase_entries( row.quantities, is_dust );
+    modified |= erase_entries( row.profits, is_dust );
+    return modified;
+}
+
+bool sx::stats::prune_row( gateway_row & row, const int64_t dust )
+{
+    const auto is_dust = [&]( const auto & entry ) { return entry.amount >= -dust && entry.amount <= dust; };
+    bool modified = erase_entries( row.ins, is_dust );
+    modified |= erase_entries( row.outs, is_dust );
+    modified |= erase_entries( row.savings, is_dust );
+    modified |= erase_entries( row.fees, is_dust );
+    return modified;
+}
+
+template <typename T>
+void sx::stats::add_counters( const name contract, const map<name, uint64_t> & counters )
+{
+    T _counters( get_self(), contract.value );
+
+    for ( const auto & [ key, transactions ] : counters ) {
+        auto itr = _counters.find( key.value );
+        if ( itr == _counters.end() ) {
+            _counters.emplace( get_self(), [&]( auto & row ) {
+                row.key = key;
+                row.transactions = transactions;
+            });
+        } else {
+            _counters.modify( itr, same_payer, [&]( auto & row ) {
+                row.transactions += transactions;
+            });
+        }
+    }
+}
+
+template <typename T>
+void sx::stats::add_hitters( const name contract, const map<name, uint64_t> & counters, const uint32_t capacity )
+{
+    T _hitters( get_self(), get_self().value );
+    auto itr = _hitters.find( contract.value );
+
+    const auto insert = [&]( auto & row ) {
+        // shrink sketch if `topk` was lowered
+        if ( row.hitters.size() > capacity ) {
+            sort( row.hitters.begin(), row.hitters.end(), []( const hitter & a, const hitter & b ) {
+                return a.transactions > b.transactions;
+            });
+            row.hitters.resize( capacity );
+        }
+        for ( const auto & [ key, transactions ] : counters ) {
+            add_hitter( row.hitters, key, transactions, capacity );
+        }
+    };
+
+    // save table
+    if ( itr == _hitters.end() ) {
+        _hitters.emplace( get_self(), [&]( auto & row ) {
+            row.contract = contract;
+            insert( row );
+        });
+    } else {
+        _hitters.modify( itr, same_payer, insert );
+    }
+}
+
+void sx::stats::add_hitter( vector<hitter> & hitters, const name key, const uint64_t transactions, const uint32_t capacity )
+{
+    // Space-Saving: increment tracked key, otherwise replace the minimum
+    auto min = hitters.end();
+    for ( auto itr = hitters.begin(); itr != hitters.end(); ++itr ) {
+        if ( itr->key == key ) {
+            itr->transactions += transactions;
+            return;
+        }
+        if ( min == hitters.end() || itr->transactions < min->transactions ) min = itr;
+    }
+    if ( hitters.size() < capacity ) hitters.push_back( hitter{ key, transactions, 0 } );
+    else *min = hitter{ key, min->transactions + transactions, min->transactions };
+}
+
+uint64_t sx::stats::drain_counters( map<name, uint64_t> & from, map<name, uint64_t> & to, const uint64_t limit )
+{
+    uint64_t moved = 0;
+    while ( moved < limit && !from.empty() ) {
+        auto itr = from.begin();
+        to[ itr->first ] += itr->second;
+        from.erase( itr );
+        moved += 1;
+    }
+    return moved;
+}
+
+template <typename T>
+map<name, vector<T>> sx::stats::group_by_contract( const vector<T> & records )
+{
+    check( records.size(), "records is empty");
+
+    map<name, vector<T>> batches;
+    for ( const T & record : records ) {
+        batches[ record.contract ].push_back( record );
+    }
+    return batches;
+}
+
+template <typename T, typename Updater>
+void sx::stats::update_bucket( const name contract, const uint32_t interval, const uint32_t capacity, const Updater & updater )
+{
+    T _buckets( get_self(), contract.value );
+
+    const uint32_t now = current_time_point().sec_since_epoch();
+    const time_point_sec bucket = time_point_sec( now - now % interval );
+    const uint64_t slot = ( now / interval ) % capacity;
+    auto itr = _buckets.find( slot );
+
+    // save table
+    if ( itr == _buckets.end() ) {
+        _buckets.emplace( get_self(), [&]( auto & row ) {
+            row.slot = slot;
+            row.bucket = bucket;
+            row.transactions = 0;
+            updater( row );
+        });
+    } else {
+        _buckets.modify( itr, same_payer, [&]( auto & row ) {
+            // ring slot holds an expired bucket, overwrite it
+            if ( row.bucket != bucket ) row = decay_t<decltype(row)>{ slot, bucket };
+            updater( row );
+        });
+    }
+}
+
+template <typename T>
+sx::stats::columns_result sx::stats::get_columns( const name cursor, const uint32_t limit )
+{
+    T _table( get_self(), get_self().value );
+
+    columns_result result;
+    result.fields = { begin( COLUMN_FIELDS ), end( COLUMN_FIELDS ) };
+    auto itr = _table.lower_bound( cursor.value );
+    for ( ; itr != _table.end() && result.contracts.size() < limit; ++itr ) {
+        result.contracts.push_back( itr->contract );
+        result.last_modified.push_back( itr->last_modified.sec_since_epoch() );
+        result.transactions.push_back( itr->transactions );
+        add_columns( result, *itr );
+    }
+    if ( itr != _table.end() ) result.next = itr->contract;
+    return result;
+}
+
+void sx::stats::add_columns( columns_result & result, const volume_row & row )
+{
+    add_column( result, "volume"_n, row.volume );
+    add_column( result, "fees"_n, row.fees );
+}
+
+void sx::stats::add_columns( columns_result & result, const flash_row & row )
+{
+    add_column( result, "borrow"_n, row.borrow );
+    add_column( result, "fees"_n, row.fees );
+    add_column( result, "reserves"_n, row.reserves );
+}
+
+void sx::stats::add_columns( columns_result & result, const trades_row & row )
+{
+    add_column( result, "borrow"_n, row.borrow );
+    add_column( result, "quantities"_n, row.quantities );
+    add_column( result, "symcodes"_n, row.symcodes );
+    add_column( result, "profits"_n, row.profits );
+}
+
+void sx::stats::add_columns( columns_result & result, const gateway_row & row )
+{
+    add_column( result, "ins"_n, "ins.tx"_n, row.ins );
+    add_column( result, "outs"_n, "outs.tx"_n, row.outs );
+    add_column( result, "savings"_n, row.savings );
+    add_column( result, "fees"_n, row.fees );
+}
+
+void sx::stats::add_column( columns_result & result, const name field, const vector<flat_asset> & entries )
+{
+    for ( const flat_asset & entry : entries ) {
+        add_entry( result, field, entry.symcode, entry.precision, entry.amount );
+    }
+}
+
+void sx::stats::add_column( columns_result & result, const name field, const name counts_field, const vector<flat_counted_asset> & entries )
+{
+    for ( const flat_counted_asset & entry : entries ) {
+        add_entry( result, field, entry.symcode, entry.precision, entry.amount );
+        add_entry( result, counts_field, entry.symcode, 0, entry.transactions );
+    }
+}
+
+void sx::stats::add_column( columns_result & result, const name field, const map<symbol_code, uint64_t> & counts )
+{
+    for ( const auto & [ symcode, transactions ] : counts ) {
+        add_entry( result, field, symcode, 0, transactions );
+    }
+}
+
+void sx::stats::add_entry( columns_result & result, const name field, const symbol_code symcode, const uint8_t precision, const int64_t amount )
+{
+    result.entry_rows.push_back( result.contracts.size() - 1 );
+    result.entry_fields.push_back( get_field_id( field ) );
+    result.entry_symcodes.push_back( get_symbol_id( symcode ) );
+    result.entry_precisions.push_back( precision );
+    result.entry_amounts.push_back( amount );
+}
+
+uint8_t sx::stats::get_field_id( const name field )
+{
+    const auto itr = find( begin( COLUMN_FIELDS ), end( COLUMN_FIELDS ), field );
+    check( itr != end( COLUMN_FIELDS ), "field has no column id");
+    return itr - begin( COLUMN_FIELDS );
+}
+
+uint32_t sx::stats::get_symbol_id( const symbol_code symcode )
+{
+    sx::stats::symbols _symbols( get_self(), get_self().value );
+    auto _bysymcode = _symbols.get_index<"bysymcode"_n>();
+    const auto itr = _bysymcode.find( symcode.raw() );
+    check( itr != _bysymcode.end(), "symbol code " + symcode.to_string() + " has no id, run `rebuild` of table");
+    return itr->id;
+}
+
+void sx::stats::add_symbols( const set<symbol_code> & symcodes )
+{
+    sx::stats::symbols _symbols( get_self(), get_self().value );
+    auto _bysymcode = _symbols.get_index<"bysymcode"_n>();
+
+    for ( const symbol_code symcode : symcodes ) {
+        if ( _bysymcode.find( symcode.raw() ) != _bysymcode.end() ) continue;
+
+        // save table
+        _symbols.emplace( get_self(), [&]( auto & row ) {
+            row.id = _symbols.available_primary_key();
+            row.symcode = symcode;
+        });
+    }
+}
+
+template <typename T>
+void sx::stats::get_symcodes( const vector<T> & entries, set<symbol_code> & symcodes )
+{
+    for ( const T & entry : entries ) symcodes.insert( entry.symcode );
+}
+
+void sx::stats::get_symcodes( const volume_row & row, set<symbol_code> & symcodes )
+{
+    get_symcodes( row.volume, symcodes );
+    get_symcodes( row.fees, symcodes );
+}
+
+void sx::stats::get_symcodes( const flash_row & row, set<symbol_code> & symcodes )
+{
+    get_symcodes( row.borrow, symcodes );
+    get_symcodes( row.fees, symcodes );
+    get_symcodes( row.reserves, symcodes );
+}
+
+void sx::stats::get_symcodes( const trades_row & row, set<symbol_code> & symcodes )
+{
+    get_symcodes( row.borrow, symcodes );
+    get_symcodes( row.quantities, symcodes );
+    for ( const auto & [ symcode, transactions ] : row.symcodes ) symcodes.insert( symcode );
+    get_symcodes( row.profits, symcodes );
+}
+
+void sx::stats::get_symcodes( const gateway_row & row, set<symbol_code> & symcodes )
+{
+    get_symcodes( row.ins, symcodes );
+    get_symcodes( row.outs, symcodes );
+    get_symcodes( row.savings, symcodes );
+    get_symcodes( row.fees, symcodes );
+}
+
+size_t sx::stats::count_entries( const volume_row & row )
+{
+    return row.volume.size() + row.fees.size();
+}
+
+size_t sx::stats::count_entries( const flash_row & row )
+{
+    return row.borrow.size() + row.fees.size() + row.reserves.size();
+}
+
+size_t sx::stats::count_entries( const trades_row & row )
+{
+    return row.borrow.size() + row.quantities.size() + row.symcodes.size() + row.profits.size();
+}
+
+size_t sx::stats::count_entries( const gateway_row & row )
+{
+    return row.ins.size() + row.outs.size() + row.savings.size() + row.fees.size();
+}
+
+bool sx::stats::filter( volume_row & row, const symbol_code symcode )
+{
+    bool found = filter_entries( row.volume, symcode );
+    found |= filter_entries( row.fees, symcode );
+    return found;
+}
+
+bool sx::stats::filter( flash_row & row, const symbol_code symcode )
+{
+    bool found = filter_entries( row.borrow, symcode );
+    found |= filter_entries( row.fees, symcode );
+    found |= filter_entries( row.reserves, symcode );
+    return found;
 }
 
-double sx::stats::get_spot_price( const name contract, const symbol_code base, const symbol_code quote )
+bool sx::stats::filter( trades_row & row, const symbol_code symcode )
 {
-    if ( !is_token_exists( contract, base ) ) return 0;
-    if ( !is_token_exists( contract, quote ) ) return 0;
+    bool found = filter_entries( row.borrow, symcode );
+    found |= filter_entries( row.quantities, symcode );
+    found |= filter_entries( row.profits, symcode );
 
-    const auto [reserve_in, reserve_out] = sx::swap::get_virtual_reserves( contract, base, quote );
-    return sx::utils::asset_to_double( reserve_in ) / sx::utils::asset_to_double( reserve_out );
+    const auto itr = row.symcodes.find( symcode );
+    const uint64_t transactions = itr != row.symcodes.end() ? itr->second : 0;
+    row.symcodes.clear();
+    if ( transactions ) row.symcodes[ symcode ] = transactions;
+    return found || transactions;
 }
 
-map<symbol_code, double> sx::stats::get_spot_prices( const name contract, const symbol_code base )
+bool sx::stats::filter( gateway_row & row, const symbol_code symcode )
 {
+    bool found = filter_entries( row.ins, symcode );
+    found |= filter_entries( row.outs, symcode );
+    found |= filter_entries( row.savings, symcode );
+    found |= filter_entries( row.fees, symcode );
+    return found;
+}
+
+template <typename T>
+bool sx::stats::filter_entries( vector<T> & entries, const symbol_code symcode )
+{
+    entries.erase( remove_if( entries.begin(), entries.end(), [&]( const T & entry ) {
+        return entry.symcode != symcode;
+    }), entries.end() );
+    return !entries.empty();
+}
+
+sx::stats::config_row sx::stats::get_config()
+{
+    sx::stats::config _config( get_self(), get_self().value );
+    return _config.get_or_default();
+}
+
+void sx::stats::update_spot_prices( const name contract, const vector<symbol_code> & bases, const map<symbol_code, vector<quote_price>> & matrix, const config_row & config )
+{
+    sx::stats::prices _prices( get_self(), contract.value );
+    const uint32_t throttle = config.throttle.value_or();
+    const uint32_t now = current_time_point().sec_since_epoch();
+
+    // full refresh if contract has no quotes yet for any base, or once throttle elapsed
+    // so symbols traded while throttled are caught up
+    for ( const symbol_code base : bases ) {
+        auto itr = _prices.find( base.raw() );
+        if ( itr == _prices.end() ) return refresh_spot_prices( contract, bases );
+        if ( throttle && now >= itr->last_modified.sec_since_epoch() + uint64_t( throttle ) ) return refresh_spot_prices( contract, bases );
+    }
+
+    // only replace quotes of traded symbols & bases, within throttle only when moved beyond threshold
+    // (`last_modified` is kept as start of the throttle window)
+    for ( const symbol_code base : bases ) {
+        const auto & itr = _prices.get( base.raw() );
+        if ( throttle && !has_moved( itr, matrix.at( base ), config.threshold.value_or() ) ) continue;
+
+        _prices.modify( itr, same_payer, [&]( auto & row ) {
+            if ( !throttle ) row.last_modified = current_time_point();
+            for ( const quote_price & quote : matrix.at( base ) ) {
+                set_quote( row.quotes, quote.symcode, quote.price );
+            }
+        });
+    }
+}
+
+bool sx::stats::has_moved( const prices_row & row, const vector<quote_price> & quotes, const uint32_t threshold )
+{
+    if ( !threshold ) return false;
+
+    // any quote is new or moved more than threshold (bps)
+    for ( const quote_price & quote : quotes ) {
+        const quote_price * last = find_entry( row.quotes, quote.symcode );
+        if ( !last ) return true;
+        const int128_t delta = quote.price > last->price ? quote.price - last->price : last->price - quote.price;
+        if ( delta > last->price / 10000 * threshold ) return true;
+    }
+    return false;
+}
+
+void sx::stats::refresh_spot_prices( const name contract, const vector<symbol_code> & bases )
+{
+    sx::stats::prices _prices( get_self(), contract.value );
+
+    for ( const auto & [ base, quotes ] : get_spot_prices( contract, bases, {} ) ) {
+        auto itr = _prices.find( base.raw() );
+
+        // save table
+        if ( itr == _prices.end() ) {
+            _prices.emplace(get_self(), [&]( auto & row ) {
+                row.base = base;
+                row.last_modified = current_time_point();
+                row.quotes = quotes;
+            });
+        } else {
+            _prices.modify( itr, same_payer, [&]( auto & row ) {
+                row.last_modified = current_time_point();
+                row.quotes = quotes;
+            });
+        }
+    }
+}
+
+void sx::stats::set_quote( vector<quote_price> & quotes, const symbol_code symcode, const int128_t price )
+{
+    auto itr = lower_bound( quotes.begin(), quotes.end(), symcode, []( const quote_price & entry, const symbol_code symcode ) {
+        return entry.symcode < symcode;
+    });
+    if ( itr == quotes.end() || itr->symcode != symcode ) itr = quotes.insert( itr, quote_price{ symcode, 0 } );
+    itr->price = price;
+}
+
+vector<symbol_code> sx::stats::get_bases( const config_row & config )
+{
+    if ( config.bases.has_value() && config.bases->size() ) return *config.bases;
+    return { BASE_SYMCODE };
+}
+
+int128_t sx::stats::div_price( const asset numerator, const asset denominator )
+{
+    // amounts rescaled by the difference of precisions
+    return div_fixed( numerator.amount, denominator.amount, PRICE_PRECISION + denominator.symbol.precision() - numerator.symbol.precision() );
+}
+
+int128_t sx::stats::div_fixed( const int128_t numerator, const int128_t denominator, int exponent )
+{
+    if ( denominator <= 0 || numerator <= 0 ) return 0;
+
+    // negative exponent: floor(floor(a / 10) / b) == floor(a / (10 * b))
+    int128_t value = numerator;
+    for ( ; exponent < 0; ++exponent ) value /= 10;
+
+    // long division of numerator * 10^exponent, in chunks of 18 digits while remainder * 10^18 fits int128
+    const int chunk = denominator < ( int128_t( 1 ) << 63 ) ? 18 : 1;
+    int128_t quotient = value / denominator;
+    int128_t remainder = value % denominator;
+    while ( exponent > 0 ) {
+        const int digits = min( exponent, chunk );
+        int128_t scale = 1;
+        for ( int i = 0; i < digits; ++i ) scale *= 10;
+
+        // saturate absurd prices rather than failing the swap notification
+        if ( quotient > MAX_PRICE / scale ) return MAX_PRICE;
+
+        remainder *= scale;
+        quotient = quotient * scale + remainder / denominator;
+        remainder %= denominator;
+        exponent -= digits;
+    }
+    return min( quotient, MAX_PRICE );
+}
+
+map<symbol_code, vector<sx::stats::quote_price>> sx::stats::get_spot_prices( const name contract, const vector<symbol_code> & bases, const set<symbol_code> & symcodes )
+{
+    // listed tokens, full scan only when every token is quoted
     sx::swap::tokens _tokens( contract, contract.value );
-    map<symbol_code, double> spot_prices;
+    set<symbol_code> tokens;
+    if ( symcodes.empty() ) {
+        for ( const auto & token : _tokens ) tokens.insert( token.sym.code() );
+    }
+
+    // quotes of given symbols (every token when empty) & bases
+    set<symbol_code> quotes = symcodes.empty() ? tokens : symcodes;
+    for ( const symbol_code base : bases ) quotes.insert( base );
+    if ( !symcodes.empty() ) {
+        for ( const symbol_code quote : quotes ) {
+            if ( _tokens.find( quote.raw() ) != _tokens.end() ) tokens.insert( quote );
+        }
+    }
+
+    // pivot is the first base listed by the contract
+    auto pivot = find_if( bases.begin(), bases.end(), [&]( const symbol_code base ) {
+        return tokens.count( base );
+    });
+
+    // virtual reserves read once per quote, priced against pivot
+    map<symbol_code, int128_t> pivot_prices;
+    for ( const symbol_code quote : quotes ) {
+        if ( pivot == bases.end() || !tokens.count( quote ) ) pivot_prices[ quote ] = 0;
+        else if ( quote == *pivot ) pivot_prices[ quote ] = PRICE_UNIT;
+        else {
+            const auto [reserve_in, reserve_out] = sx::swap::get_virtual_reserves( contract, *pivot, quote );
+            pivot_prices[ quote ] = div_price( reserve_in, reserve_out );
+        }
+    }
 
-    for ( const auto token : _tokens ) {
-        const symbol_code quote = token.sym.code();
-        spot_prices[ quote ] = get_spot_price( contract, base, quote );
+    // cross rates of other bases
+    map<symbol_code, vector<quote_price>> matrix;
+    for ( const symbol_code base : bases ) {
+        auto & row = matrix[ base ];
+        for ( const auto & [ quote, price ] : pivot_prices ) {
+            const bool is_pivot = pivot != bases.end() && base == *pivot;
+            const int128_t value = is_pivot ? price : div_fixed( price, pivot_prices[ base ], PRICE_PRECISION );
+            row.push_back( quote_price{ quote, value } );
+        }
     }
-    return spot_prices;
-}
\ No newline at end of file
+    return matrix;
+}
+
+template <typename T>
+void sx::stats::update_candles( const name contract, const uint32_t interval, const uint32_t capacity, const symbol_code base, const vector<quote_price> & quotes, const map<symbol_code, asset> & volumes, const map<symbol_code, uint64_t> & transactions )
+{
+    T _candles( get_self(), contract.value );
+    auto _byquote = _candles.template get_index<"byquote"_n>();
+
+    const uint32_t now = current_time_point().sec_since_epoch();
+    const uint32_t start = now - now % interval;
+
+    for ( const auto & [ quote, volume ] : volumes ) {
+        const int128_t price = find_entry( quotes, quote )->price;
+        if ( quote == base || !price ) continue;
+        auto itr = _byquote.find( candle_key( quote, start ) );
+
+        // save table
+        if ( itr == _byquote.end() ) {
+            _candles.emplace( get_self(), [&]( auto & row ) {
+                row.id = _candles.available_primary_key();
+                row.quote = quote;
+                row.start = time_point_sec( start );
+                row.open = price;
+                row.high = price;
+                row.low = price;
+                row.close = price;
+                row.volume = volume;
+                row.transactions = transactions.at( quote );
+            });
+
+            // drop expired candles of quote (bounded, catches up when `config.candles` is lowered)
+            auto oldest = _byquote.lower_bound( candle_key( quote, 0 ) );
+            for ( int i = 0; i < 2 && oldest != _byquote.end() && oldest->quote == quote; ++i ) {
+                if ( oldest->start.sec_since_epoch() + uint64_t( capacity ) * interval > start ) break;
+                oldest = _byquote.erase( oldest );
+            }
+        } else {
+            _byquote.modify( itr, same_payer, [&]( auto & row ) {
+                row.high = max( row.high, price );
+                row.low = min( row.low, price );
+                row.close = price;
+                row.volume += volume;
+                row.transactions += transactions.at( quote );
+            });
+        }
+    }
+}
+
+void sx::stats::update_twap( const name contract, const symbol_code base, const vector<quote_price> & quotes )
+{
+    sx::stats::twap _twap( get_self(), contract.value );
+    const time_point_sec now = current_time_point();
+
+    for ( const auto & [ quote, price ] : quotes ) {
+        if ( quote == base || !price ) continue;
+        auto itr = _twap.find( quote.raw() );
+
+        // save table
+        if ( itr == _twap.end() ) {
+            _twap.emplace( get_self(), [&]( auto & row ) {
+                row.quote = quote;
+                row.base = base;
+                row.last_modified = now;
+                row.price = price;
+                row.cumulative = 0;
+                add_checkpoint( row.checkpoints, now, row.cumulative );
+            });
+        } else {
+            _twap.modify( itr, same_payer, [&]( auto & row ) {
+                // base changed (`config.bases`), restart accumulator
+                if ( row.base != base ) {
+                    row = { quote, base, now, price, 0 };
+                    return add_checkpoint( row.checkpoints, now, row.cumulative );
+                }
+                // previous price was in effect since last modified (wraps around 2^128)
+                row.cumulative += uint128_t( row.price ) * ( now.sec_since_epoch() - row.last_modified.sec_since_epoch() );
+                row.last_modified = now;
+                row.price = price;
+                add_checkpoint( row.checkpoints, now, row.cumulative );
+            });
+        }
+    }
+}
+
+void sx::stats::add_checkpoint( vector<checkpoint> & checkpoints, const time_point_sec timestamp, const uint128_t cumulative )
+{
+    // at most one checkpoint per hour
+    if ( checkpoints.size() && checkpoints.back().timestamp.sec_since_epoch() + HOUR > timestamp.sec_since_epoch() ) return;
+
+    // ring of hourly checkpoints, drop oldest
+    if ( checkpoints.size() >= HOURLY_BUCKETS ) checkpoints.erase( checkpoints.begin() );
+    checkpoints.push_back( checkpoint{ timestamp, cumulative } );
+}
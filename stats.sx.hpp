@@ -1,5 +1,8 @@
+#pragma once
+
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
+#include <eosio/singleton.hpp>
 
 using namespace eosio;
 using namespace std;
@@ -12,13 +15,101 @@ public:
     using contract::contract;
 
     /**
-     * ## TABLE `volume`
+     * ## TABLE `config`
+     *
+     * - `{bool} spotprices` - write `prices` on every swap (default: `true`)
+     * - `{uint32_t} [topk=0]` - track only top K executors & exchanges in `topexecutors` & `topexchanges` (`0` for exact counters)
+     * - `{uint32_t} [candles=0]` - number of candles kept per quote in `candles.m`, `candles.h` & `candles.d` (`0` disables candles)
+     * - `{vector<symbol_code>} [bases=["USDT"]]` - bases of `prices` rows, first listed base is the pivot of cross rates, first base is the base of `twap` & candles (not updated while contract has no reserves of it)
+     * - `{uint32_t} [throttle=0]` - seconds between full refreshes of `prices` rows (every token) triggered by swaps, traded quotes are not written in between (`0` writes traded quotes on every swap)
+     * - `{uint32_t} [threshold=0]` - within `throttle`, still write traded quotes that are new or moved by more than threshold basis points (`0` disabled)
+     * - `{bool} [minimal=false]` - only write `*.v2` rows, totals, counters & `prices`; skip rolling buckets, traders, twap, candles, activity & sizes (skipped tables are rebuilt off-chain from action traces by `native/indexer`)
+     *
+     * > when disabled, quotes are computed on demand with `getprices`, `refresh` always writes regardless of `throttle`
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "spotprices": false,
+     *     "topk": 20,
+     *     "candles": 120,
+     *     "bases": ["USDT", "EOS"],
+     *     "throttle": 60,
+     *     "threshold": 50,
+     *     "minimal": false
+     * }
+     * ```
+     */
+    struct [[eosio::table("config")]] config_row {
+        bool                            spotprices = true;
+        binary_extension<uint32_t>      topk;
+        binary_extension<uint32_t>      candles;
+        binary_extension<vector<symbol_code>> bases;
+        binary_extension<uint32_t>      throttle;
+        binary_extension<uint32_t>      threshold;
+        binary_extension<bool>          minimal;
+    };
+    typedef eosio::singleton< "config"_n, config_row > config;
+
+    /**
+     * ## STRUCT `flat_asset`
+     *
+     * Compact per-symbol amount, entries are sorted by symbol code
+     *
+     * - `{symbol_code} symcode` - symbol code
+     * - `{uint8_t} precision` - symbol precision
+     * - `{int64_t} amount` - amount
+     *
+     * ### example
+     *
+     * ```json
+     * {"symcode": "EOS", "precision": 4, "amount": 250000}
+     * ```
+     */
+    struct flat_asset {
+        symbol_code     symcode;
+        uint8_t         precision;
+        int64_t         amount;
+
+        asset quantity() const { return asset{ amount, symbol{ symcode, precision } }; }
+    };
+
+    /**
+     * ## STRUCT `flat_counted_asset`
+     *
+     * Compact per-symbol amount & number of transactions, entries are sorted by symbol code
+     *
+     * - `{symbol_code} symcode` - symbol code
+     * - `{uint8_t} precision` - symbol precision
+     * - `{uint64_t} transactions` - total amount of transactions
+     * - `{int64_t} amount` - amount
+     *
+     * ### example
+     *
+     * ```json
+     * {"symcode": "EOS", "precision": 4, "transactions": 123, "amount": 493878252}
+     * ```
+     */
+    struct flat_counted_asset {
+        symbol_code     symcode;
+        uint8_t         precision;
+        uint64_t        transactions;
+        int64_t         amount;
+
+        asset quantity() const { return asset{ amount, symbol{ symcode, precision } }; }
+    };
+
+    /**
+     * ## TABLE `volume.v2`
+     *
+     * > reserved row `contract: get_self()` holds the totals of every contract
      *
      * - `{name} contract` - (primary key) contract name
      * - `{time_point_sec} last_modified` - last modified timestamp
      * - `{uint64_t} transactions` - total amount of transactions
-     * - `{map<symbol_code, asset>} fees` - total fees collected
-     * - `{map<symbol_code, asset>} volume` - total trading volume of assets
+     * - `{vector<flat_asset>} volume` - total trading volume of assets
+     * - `{vector<flat_asset>} fees` - total fees collected
      *
      * ### example
      *
@@ -28,36 +119,38 @@ public:
      *     "last_modified": "2020-06-03T00:00:00",
      *     "transactions": 110,
      *     "volume": [
-     *         {"key": "EOS", "value": "25.0000 EOS"},
-     *         {"key": "USDT", "value": "100.0000 USDT"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 250000},
+     *         {"symcode": "USDT", "precision": 4, "amount": 1000000}
      *     ],
      *     "fees": [
-     *         {"key": "EOS", "value": "0.1250 EOS"},
-     *         {"key": "USDT", "value": "0.5000 USDT"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 1250},
+     *         {"symcode": "USDT", "precision": 4, "amount": 5000}
      *     ]
      * }
      * ```
      */
-    struct [[eosio::table("volume")]] volume_row {
+    struct [[eosio::table("volume.v2")]] volume_row {
         name                            contract;
         time_point_sec                  last_modified;
         uint64_t                        transactions;
-        map<symbol_code, asset>         volume;
-        map<symbol_code, asset>         fees;
+        vector<flat_asset>              volume;
+        vector<flat_asset>              fees;
 
         uint64_t primary_key() const { return contract.value; }
     };
-    typedef eosio::multi_index< "volume"_n, volume_row > volume;
+    typedef eosio::multi_index< "volume.v2"_n, volume_row > volume;
 
     /**
-     * ## TABLE `flash`
+     * ## TABLE `flash.v2`
+     *
+     * > reserved row `contract: get_self()` holds the totals of every contract
      *
      * - `{name} contract` - (primary key) contract name
      * - `{time_point_sec} last_modified` - last modified timestamp
      * - `{uint64_t} transactions` - total amount of transactions
-     * - `{map<symbol_code, asset>} borrow` - total borrowed asset from flash contract
-     * - `{map<symbol_code, asset>} fees` - total fees collected
-     * - `{map<symbol_code, asset>} reserves` - total reserve assets of flash contract
+     * - `{vector<flat_asset>} borrow` - total borrowed asset from flash contract
+     * - `{vector<flat_asset>} fees` - total fees collected
+     * - `{vector<flat_asset>} reserves` - total reserve assets of flash contract
      *
      * ### example
      *
@@ -67,35 +160,88 @@ public:
      *     "last_modified": "2020-06-03T00:00:00",
      *     "transactions": 110,
      *     "borrow": [
-     *         {"key": "EOS", "value": "2500.0000 EOS"},
-     *         {"key": "USDT", "value": "100.0000 USDT"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 25000000},
+     *         {"symcode": "USDT", "precision": 4, "amount": 1000000}
      *     ],
      *     "fees": [
-     *         {"key": "EOS", "value": "0.1250 EOS"},
-     *         {"key": "USDT", "value": "0.0100 USDT"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 1250},
+     *         {"symcode": "USDT", "precision": 4, "amount": 100}
      *     ],
      *     "reserves": [
-     *         {"key": "EOS", "value": "900.0000 EOS"},
-     *         {"key": "USDT", "value": "200.0000 USDT"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 9000000},
+     *         {"symcode": "USDT", "precision": 4, "amount": 2000000}
      *     ]
      * }
      * ```
      */
-    struct [[eosio::table("flash")]] flash_row {
+    struct [[eosio::table("flash.v2")]] flash_row {
         name                            contract;
         time_point_sec                  last_modified;
         uint64_t                        transactions;
-        map<symbol_code, asset>         borrow;
-        map<symbol_code, asset>         fees;
-        map<symbol_code, asset>         reserves;
+        vector<flat_asset>              borrow;
+        vector<flat_asset>              fees;
+        vector<flat_asset>              reserves;
 
         uint64_t primary_key() const { return contract.value; }
     };
-    typedef eosio::multi_index< "flash"_n, flash_row > flash;
+    typedef eosio::multi_index< "flash.v2"_n, flash_row > flash;
+
+    /**
+     * ## STRUCT `quote_price`
+     *
+     * Price of a quote relative to base, entries are sorted by symbol code
+     *
+     * - `{symbol_code} symcode` - quote symbol code
+     * - `{int128_t} price` - price (18 decimals fixed-point)
+     *
+     * ### example
+     *
+     * ```json
+     * {"symcode": "EOS", "price": "2609800000000000000"}
+     * ```
+     */
+    struct quote_price {
+        symbol_code     symcode;
+        int128_t        price;
+    };
+
+    /**
+     * ## TABLE `prices`
+     *
+     * > scoped by contract, one row per `config.bases`, prices are fixed-point with 18 decimals,
+     * > computed from reserves against the first base and converted to other bases by cross rate
+     *
+     * - `{symbol_code} base` - (primary key) base symbol code
+     * - `{time_point_sec} last_modified` - last modified timestamp (last full refresh when `config.throttle` is set)
+     * - `{vector<quote_price>} quotes` - quotes prices calculated relative to base
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "base": "USDT",
+     *     "last_modified": "2020-07-10T15:17:23",
+     *     "quotes": [
+     *         {"symcode": "EOS", "price": "2609800000000000000"},
+     *         {"symcode": "USDT", "price": "1000000000000000000"}
+     *     ]
+     * }
+     * ```
+     */
+    struct [[eosio::table("prices")]] prices_row {
+        symbol_code                 base;
+        time_point_sec              last_modified;
+        vector<quote_price>         quotes;
+
+        uint64_t primary_key() const { return base.raw(); }
+    };
+    typedef eosio::multi_index< "prices"_n, prices_row > prices;
 
     /**
      * ## TABLE `spotprices`
      *
+     * > deprecated, no longer updated (replaced by `prices`), rows are removed by `migrate`
+     *
      * - `{name} contract` - (primary key) contract name
      * - `{time_point_sec} last_modified` - last modified timestamp
      * - `{symbol_code} base` - base symbol code
@@ -126,16 +272,19 @@ public:
     typedef eosio::multi_index< "spotprices"_n, spotprices_row > spotprices;
 
     /**
-     * ## TABLE `trades`
+     * ## TABLE `trades.v2`
+     *
+     * > reserved row `contract: get_self()` holds the totals of every contract
      *
      * - `{name} contract` - (primary key) contract name
      * - `{time_point_sec} last_modified` - last modified timestamp
      * - `{uint64_t} transactions` - total amount of transactions
-     * - `{map<symbol_code, asset>} quantities` - total quantity traded
-     * - `{map<name, uint64_t>} codes` - total transactions per contract codes
-     * - `{map<symbol_code, uint64_t>} symbcodes` - total transactions per symbol code used
-     * - `{map<name, uint64_t>} executors` - total transactions per executor
-     * - `{map<symbol_code, asset>} profits` - total profits
+     * - `{vector<flat_asset>} borrow` - total borrowed quantity
+     * - `{vector<flat_asset>} quantities` - total quantity traded
+     * - `{map<symbol_code, uint64_t>} symcodes` - total transactions per symbol code used
+     * - `{vector<flat_asset>} profits` - total profits
+     *
+     * > transactions per executor & contract code are stored in `executors` & `codes` tables
      *
      * ### example
      *
@@ -145,57 +294,50 @@ public:
      *     "last_modified": "2020-06-03T00:00:00",
      *     "transactions": 640,
      *     "borrow": [
-     *         {"key": "EOS", "value": "49387.8252 EOS"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 493878252}
      *     ],
      *     "quantities": [
-     *         {"key": "EOS", "value": "5030.3050 EOS"},
-     *         {"key": "USDT", "value": "400.0100 USDT"}
-     *     ],
-     *     "codes": [
-     *         {"key": "swap.defi", "value": 512},
-     *         {"key": "swap.sx", "value": 100}
+     *         {"symcode": "EOS", "precision": 4, "amount": 50303050},
+     *         {"symcode": "USDT", "precision": 4, "amount": 4000100}
      *     ],
      *     "symcodes": [
      *         {"key": "EOS", "value": 610},
      *         {"key": "USDT", "value": 30}
      *     ],
-     *     "executors": [
-     *         {"key": "myaccount", "value": 80},
-     *         {"key": "miner.sx", "value": 200}
-     *     ],
      *     "profits": [
-     *         {"key": "EOS", "value": "50.3050 EOS"},
-     *         {"key": "USDT", "value": "4.0100 USDT"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 503050},
+     *         {"symcode": "USDT", "precision": 4, "amount": 40100}
      *     ]
      * }
      * ```
      */
-    struct [[eosio::table("trades")]] trades_row {
+    struct [[eosio::table("trades.v2")]] trades_row {
         name                            contract;
         time_point_sec                  last_modified;
         uint64_t                        transactions;
-        map<symbol_code, asset>         borrow;
-        map<symbol_code, asset>         quantities;
-        map<name, uint64_t>             codes;
+        vector<flat_asset>              borrow;
+        vector<flat_asset>              quantities;
         map<symbol_code, uint64_t>      symcodes;
-        map<name, uint64_t>             executors;
-        map<symbol_code, asset>         profits;
+        vector<flat_asset>              profits;
 
         uint64_t primary_key() const { return contract.value; }
     };
-    typedef eosio::multi_index< "trades"_n, trades_row > trades;
+    typedef eosio::multi_index< "trades.v2"_n, trades_row > trades;
 
     /**
-     * ## TABLE `gateway`
+     * ## TABLE `gateway.v2`
+     *
+     * > reserved row `contract: get_self()` holds the totals of every contract
      *
      * - `{name} contract` - (primary key) contract name
      * - `{time_point_sec} last_modified` - last modified timestamp
      * - `{uint64_t} transactions` - total amount of transactions
-     * - `{map<symbol_code, pair<uint64_t, asset>>} ins` - input quantities - pair{# transactions, total quantities}
-     * - `{map<symbol_code, pair<uint64_t, asset>>} outs` - output quantities - pair{# transactions, total quantities}
-     * - `{map<name, uint64_t>} exchanges` - # transactions per exchange
-     * - `{map<symbol_code, asset>} savings` - total savings
-     * - `{map<symbol_code, asset>} fees` - total fees
+     * - `{vector<flat_counted_asset>} ins` - input quantities & # transactions
+     * - `{vector<flat_counted_asset>} outs` - output quantities & # transactions
+     * - `{vector<flat_asset>} savings` - total savings
+     * - `{vector<flat_asset>} fees` - total fees
+     *
+     * > transactions per exchange are stored in `exchanges` table
      *
      * ### example
      *
@@ -205,28 +347,80 @@ public:
      *     "last_modified": "2020-06-03T00:00:00",
      *     "transactions": 640,
      *     "ins": [
-     *         {"key": "EOS", "value": {123, "49387.8252 EOS"}}
+     *         {"symcode": "EOS", "precision": 4, "transactions": 123, "amount": 493878252}
      *     ],
      *     "outs": [
-     *         {"key": "EOS", "value": {50, "5030.3050 EOS"}},
-     *         {"key": "USDT", "value": {111, "400.0100 USDT"}}
-     *     ],
-     *     "exchanges": [
-     *         {"key": "swap.defi", "value": 512},
-     *         {"key": "swap.sx", "value": 100}
+     *         {"symcode": "EOS", "precision": 4, "transactions": 50, "amount": 50303050},
+     *         {"symcode": "USDT", "precision": 4, "transactions": 111, "amount": 4000100}
      *     ],
      *     "savings": [
-     *         {"key": "EOS", "value": "10.0231 EOS"},
-     *         {"key": "USDT", "value": "12.2310 USDT"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 100231},
+     *         {"symcode": "USDT", "precision": 4, "amount": 122310}
      *     ],
      *     "fees": [
-     *         {"key": "EOS", "value": "1.0231 EOS"},
-     *         {"key": "USDT", "value": "2.2310 USDT"}
+     *         {"symcode": "EOS", "precision": 4, "amount": 10231},
+     *         {"symcode": "USDT", "precision": 4, "amount": 22310}
      *     ]
      * }
      * ```
      */
-    struct [[eosio::table("gateway")]] gateway_row {
+    struct [[eosio::table("gateway.v2")]] gateway_row {
+        name                            contract;
+        time_point_sec                  last_modified;
+        uint64_t                        transactions;
+        vector<flat_counted_asset>      ins;
+        vector<flat_counted_asset>      outs;
+        vector<flat_asset>              savings;
+        vector<flat_asset>              fees;
+
+        uint64_t primary_key() const { return contract.value; }
+    };
+    typedef eosio::multi_index< "gateway.v2"_n, gateway_row > gateway;
+
+    /**
+     * ## TABLE `volume`, `flash`, `trades` & `gateway`
+     *
+     * Legacy `map<symbol_code, asset>` layout, moved into `*.v2` tables by `migrate`
+     */
+    struct [[eosio::table("volume")]] legacy_volume_row {
+        name                            contract;
+        time_point_sec                  last_modified;
+        uint64_t                        transactions;
+        map<symbol_code, asset>         volume;
+        map<symbol_code, asset>         fees;
+
+        uint64_t primary_key() const { return contract.value; }
+    };
+    typedef eosio::multi_index< "volume"_n, legacy_volume_row > legacy_volume;
+
+    struct [[eosio::table("flash")]] legacy_flash_row {
+        name                            contract;
+        time_point_sec                  last_modified;
+        uint64_t                        transactions;
+        map<symbol_code, asset>         borrow;
+        map<symbol_code, asset>         fees;
+        map<symbol_code, asset>         reserves;
+
+        uint64_t primary_key() const { return contract.value; }
+    };
+    typedef eosio::multi_index< "flash"_n, legacy_flash_row > legacy_flash;
+
+    struct [[eosio::table("trades")]] legacy_trades_row {
+        name                            contract;
+        time_point_sec                  last_modified;
+        uint64_t                        transactions;
+        map<symbol_code, asset>         borrow;
+        map<symbol_code, asset>         quantities;
+        map<name, uint64_t>             codes;
+        map<symbol_code, uint64_t>      symcodes;
+        map<name, uint64_t>             executors;
+        map<symbol_code, asset>         profits;
+
+        uint64_t primary_key() const { return contract.value; }
+    };
+    typedef eosio::multi_index< "trades"_n, legacy_trades_row > legacy_trades;
+
+    struct [[eosio::table("gateway")]] legacy_gateway_row {
         name                                    contract;
         time_point_sec                          last_modified;
         uint64_t                                transactions;
@@ -238,59 +432,1419 @@ public:
 
         uint64_t primary_key() const { return contract.value; }
     };
-    typedef eosio::multi_index< "gateway"_n, gateway_row > gateway;
-
-    [[eosio::action]]
-    void erase( const name contract );
+    typedef eosio::multi_index< "gateway"_n, legacy_gateway_row > legacy_gateway;
 
     /**
-     * ## ACTION `swaplog`
+     * ## TABLE `volume.h` & `volume.d`
      *
-     * Notify of trade
+     * Hourly (`volume.h`) & daily (`volume.d`) rolling volume buckets
      *
-     * - **authority**: `get_self()`
+     * > scoped by contract, fixed-capacity ring (48 hours / 90 days) where expired buckets are overwritten
      *
-     * ### params
+     * - `{uint64_t} slot` - (primary key) ring slot
+     * - `{time_point_sec} bucket` - bucket start timestamp
+     * - `{uint64_t} transactions` - total amount of transactions
+     * - `{map<symbol_code, asset>} volume` - trading volume of assets
+     * - `{map<symbol_code, asset>} fees` - fees collected
      *
-     * - `{name} buyer` - trader buyer account
-     * - `{asset} amount_in` - amount incoming
-     * - `{asset} amount_out` - amount outgoing
-     * - `{asset} fee` - fee paid
+     * ### example
+     *
+     * ```json
+     * {
+     *     "slot": 20,
+     *     "bucket": "2020-06-03T20:00:00",
+     *     "transactions": 12,
+     *     "volume": [
+     *         {"key": "EOS", "value": "2.5000 EOS"},
+     *         {"key": "USDT", "value": "10.0000 USDT"}
+     *     ],
+     *     "fees": [
+     *         {"key": "EOS", "value": "0.0125 EOS"}
+     *     ]
+     * }
+     * ```
+     */
+    struct [[eosio::table]] volume_bucket_row {
+        uint64_t                        slot;
+        time_point_sec                  bucket;
+        uint64_t                        transactions;
+        map<symbol_code, asset>         volume;
+        map<symbol_code, asset>         fees;
+
+        uint64_t primary_key() const { return slot; }
+    };
+    typedef eosio::multi_index< "volume.h"_n, volume_bucket_row > volume_hourly;
+    typedef eosio::multi_index< "volume.d"_n, volume_bucket_row > volume_daily;
+
+    /**
+     * ## TABLE `trades.h` & `trades.d`
+     *
+     * Hourly (`trades.h`) & daily (`trades.d`) rolling trade buckets
+     *
+     * > scoped by contract, fixed-capacity ring (48 hours / 90 days) where expired buckets are overwritten
+     *
+     * - `{uint64_t} slot` - (primary key) ring slot
+     * - `{time_point_sec} bucket` - bucket start timestamp
+     * - `{uint64_t} transactions` - total amount of transactions
+     * - `{map<symbol_code, asset>} borrow` - borrowed quantity
+     * - `{map<symbol_code, asset>} quantities` - quantity traded
+     * - `{map<symbol_code, asset>} profits` - profits
      *
      * ### example
      *
-     * ```bash
-     * cleos push action swap.sx swaplog '["myaccount", "3.0000 EOS", "7.0486 USDT", "0.0060 EOS"]' -p swap.sx
+     * ```json
+     * {
+     *     "slot": 3,
+     *     "bucket": "2020-06-03T00:00:00",
+     *     "transactions": 64,
+     *     "borrow": [
+     *         {"key": "EOS", "value": "4938.7825 EOS"}
+     *     ],
+     *     "quantities": [
+     *         {"key": "EOS", "value": "503.0305 EOS"}
+     *     ],
+     *     "profits": [
+     *         {"key": "EOS", "value": "5.0305 EOS"}
+     *     ]
+     * }
      * ```
      */
-    [[eosio::action]]
-    void swaplog( const name contract, const name buyer, const asset amount_in, const asset amount_out, const asset fee );
+    struct [[eosio::table]] trades_bucket_row {
+        uint64_t                        slot;
+        time_point_sec                  bucket;
+        uint64_t                        transactions;
+        map<symbol_code, asset>         borrow;
+        map<symbol_code, asset>         quantities;
+        map<symbol_code, asset>         profits;
 
-    [[eosio::action]]
-    void clean( const name contract );
+        uint64_t primary_key() const { return slot; }
+    };
+    typedef eosio::multi_index< "trades.h"_n, trades_bucket_row > trades_hourly;
+    typedef eosio::multi_index< "trades.d"_n, trades_bucket_row > trades_daily;
 
-    [[eosio::on_notify("flash.sx::flashlog")]]
-    void on_flashlog( const name code, const name receiver, const extended_asset amount, const asset fee );
+    /**
+     * ## TABLE `gateway.h` & `gateway.d`
+     *
+     * Hourly (`gateway.h`) & daily (`gateway.d`) rolling gateway buckets
+     *
+     * > scoped by contract, fixed-capacity ring (48 hours / 90 days) where expired buckets are overwritten
+     *
+     * - `{uint64_t} slot` - (primary key) ring slot
+     * - `{time_point_sec} bucket` - bucket start timestamp
+     * - `{uint64_t} transactions` - total amount of transactions
+     * - `{map<symbol_code, pair<uint64_t, asset>>} ins` - input quantities - pair{# transactions, total quantities}
+     * - `{map<symbol_code, pair<uint64_t, asset>>} outs` - output quantities - pair{# transactions, total quantities}
+     * - `{map<symbol_code, asset>} savings` - savings
+     * - `{map<symbol_code, asset>} fees` - fees
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "slot": 20,
+     *     "bucket": "2020-06-03T20:00:00",
+     *     "transactions": 4,
+     *     "ins": [
+     *         {"key": "EOS", "value": [4, "120.0000 EOS"]}
+     *     ],
+     *     "outs": [
+     *         {"key": "USDT", "value": [4, "311.0100 USDT"]}
+     *     ],
+     *     "savings": [
+     *         {"key": "USDT", "value": "1.2310 USDT"}
+     *     ],
+     *     "fees": [
+     *         {"key": "USDT", "value": "0.2310 USDT"}
+     *     ]
+     * }
+     * ```
+     */
+    struct [[eosio::table]] gateway_bucket_row {
+        uint64_t                                slot;
+        time_point_sec                          bucket;
+        uint64_t                                transactions;
+        map<symbol_code, pair<uint64_t, asset>> ins;
+        map<symbol_code, pair<uint64_t, asset>> outs;
+        map<symbol_code, asset>                 savings;
+        map<symbol_code, asset>                 fees;
 
-    [[eosio::action]]
-    void tradelog( const name contract, const name executor, const asset borrow, const vector<asset> quantities, const vector<name> codes, const asset profit );
+        uint64_t primary_key() const { return slot; }
+    };
+    typedef eosio::multi_index< "gateway.h"_n, gateway_bucket_row > gateway_hourly;
+    typedef eosio::multi_index< "gateway.d"_n, gateway_bucket_row > gateway_daily;
 
-    [[eosio::action]]
-    void gatewaylog(const name contract, const asset in, const asset out, const vector<name> exchanges, const asset savings, const asset fee );
+    /**
+     * ## TABLE `executors`, `codes` & `exchanges`
+     *
+     * Transaction counters per executor (`executors`), contract code (`codes`) & exchange (`exchanges`)
+     *
+     * > scoped by contract
+     *
+     * - `{name} key` - (primary key) executor, contract code or exchange account
+     * - `{uint64_t} transactions` - total amount of transactions
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "key": "miner.sx",
+     *     "transactions": 200
+     * }
+     * ```
+     */
+    struct [[eosio::table]] counter_row {
+        name            key;
+        uint64_t        transactions;
 
-    // action wrappers
-    using swaplog_action = eosio::action_wrapper<"swaplog"_n, &sx::stats::swaplog>;
-    using tradelog_action = eosio::action_wrapper<"tradelog"_n, &sx::stats::tradelog>;
-    using gatewaylog_action = eosio::action_wrapper<"gatewaylog"_n, &sx::stats::gatewaylog>;
+        uint64_t primary_key() const { return key.value; }
+    };
+    typedef eosio::multi_index< "executors"_n, counter_row > executors;
+    typedef eosio::multi_index< "codes"_n, counter_row > codes;
+    typedef eosio::multi_index< "exchanges"_n, counter_row > exchanges;
 
-private:
-    // volume
-    void update_volume( const name contract, const vector<asset> volumes, const asset fee );
+    /**
+     * ## STRUCT `hitter`
+     *
+     * - `{name} key` - executor or exchange account
+     * - `{uint64_t} transactions` - estimated transactions (upper bound)
+     * - `{uint64_t} error` - maximum overestimation of `transactions`
+     */
+    struct hitter {
+        name            key;
+        uint64_t        transactions;
+        uint64_t        error;
+    };
 
-    // spotprices
-    void update_spot_prices( const name contract );
-    double get_spot_price( const name contract, const symbol_code base, const symbol_code quote );
-    map<symbol_code, double> get_spot_prices( const name contract, const symbol_code base );
-    bool is_token_exists( const name contract, const symbol_code symcode );
+    /**
+     * ## TABLE `topexecutors` & `topexchanges`
+     *
+     * Heavy hitters executors (`topexecutors`) & exchanges (`topexchanges`) when `config.topk` is enabled
+     *
+     * > Space-Saving sketch of at most `config.topk` entries, the account with the least transactions is replaced by a new one
+     *
+     * - `{name} contract` - (primary key) contract name
+     * - `{vector<hitter>} hitters` - tracked accounts (unsorted)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "contract": "basic.sx",
+     *     "hitters": [
+     *         {"key": "miner.sx", "transactions": 200, "error": 0},
+     *         {"key": "myaccount", "transactions": 82, "error": 2}
+     *     ]
+     * }
+     * ```
+     */
+    struct [[eosio::table]] hitters_row {
+        name                contract;
+        vector<hitter>      hitters;
+
+        uint64_t primary_key() const { return contract.value; }
+    };
+    typedef eosio::multi_index< "topexecutors"_n, hitters_row > topexecutors;
+    typedef eosio::multi_index< "topexchanges"_n, hitters_row > topexchanges;
+
+    /**
+     * ## TABLE `traders`
+     *
+     * Unique traders (`swaplog` buyers & `tradelog` executors) HyperLogLog sketch
+     *
+     * > 256 registers (~6.5% standard error), estimate with `gettraders`
+     *
+     * - `{name} contract` - (primary key) contract name
+     * - `{vector<uint8_t>} registers` - HyperLogLog registers
+     */
+    struct [[eosio::table("traders")]] traders_row {
+        name                contract;
+        vector<uint8_t>     registers;
+
+        uint64_t primary_key() const { return contract.value; }
+    };
+    typedef eosio::multi_index< "traders"_n, traders_row > traders;
+
+    /**
+     * ## TABLE `traders.d`
+     *
+     * Daily unique traders HyperLogLog sketch
+     *
+     * > scoped by contract, fixed-capacity ring (90 days) where expired buckets are overwritten
+     *
+     * - `{uint64_t} slot` - (primary key) ring slot
+     * - `{time_point_sec} bucket` - bucket start timestamp
+     * - `{uint64_t} transactions` - total amount of traders logged
+     * - `{vector<uint8_t>} registers` - HyperLogLog registers
+     */
+    struct [[eosio::table("traders.d")]] traders_bucket_row {
+        uint64_t            slot;
+        time_point_sec      bucket;
+        uint64_t            transactions;
+        vector<uint8_t>     registers;
+
+        uint64_t primary_key() const { return slot; }
+    };
+    typedef eosio::multi_index< "traders.d"_n, traders_bucket_row > traders_daily;
+
+    /**
+     * ## STRUCT `checkpoint`
+     *
+     * - `{time_point_sec} timestamp` - checkpoint timestamp
+     * - `{uint128_t} cumulative` - price cumulative at timestamp
+     */
+    struct checkpoint {
+        time_point_sec      timestamp;
+        uint128_t           cumulative;
+    };
+
+    /**
+     * ## TABLE `twap`
+     *
+     * Cumulative price accumulators for time-weighted average prices
+     *
+     * > scoped by contract, prices are fixed-point with 18 decimals relative to base
+     * > TWAP between two checkpoints is `(cumulative_b - cumulative_a) / (timestamp_b - timestamp_a)`
+     * > `cumulative` wraps around 2^128, differences are exact modulo 2^128 since prices are capped below 2^96,
+     * > accumulator & checkpoints restart when `base` changes (first of `config.bases`)
+     *
+     * - `{symbol_code} quote` - (primary key) quote symbol code
+     * - `{symbol_code} base` - base symbol code
+     * - `{time_point_sec} last_modified` - last modified timestamp
+     * - `{int128_t} price` - last price
+     * - `{uint128_t} cumulative` - sum of price × seconds up to `last_modified` (wrapping)
+     * - `{vector<checkpoint>} checkpoints` - hourly checkpoints (48 hours), oldest first
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "quote": "EOS",
+     *     "base": "USDT",
+     *     "last_modified": "2020-07-10T15:17:23",
+     *     "price": "2609800000000000000",
+     *     "cumulative": "93952800000000000000000",
+     *     "checkpoints": [
+     *         {"timestamp": "2020-07-10T05:17:23", "cumulative": "0"},
+     *         {"timestamp": "2020-07-10T06:20:03", "cumulative": "9811032000000000000000"}
+     *     ]
+     * }
+     * ```
+     */
+    struct [[eosio::table("twap")]] twap_row {
+        symbol_code             quote;
+        symbol_code             base;
+        time_point_sec          last_modified;
+        int128_t                price;
+        uint128_t               cumulative;
+        vector<checkpoint>      checkpoints;
+
+        uint64_t primary_key() const { return quote.raw(); }
+    };
+    typedef eosio::multi_index< "twap"_n, twap_row > twap;
+
+    /**
+     * ## TABLE `candles.m`, `candles.h` & `candles.d`
+     *
+     * OHLC candles per minute (`candles.m`), hour (`candles.h`) & day (`candles.d`) of quotes relative to base
+     *
+     * > scoped by contract, prices are fixed-point with 18 decimals, `config.candles` most recent candles are kept per quote
+     *
+     * - `{uint64_t} id` - (primary key) candle id
+     * - `{symbol_code} quote` - quote symbol code
+     * - `{time_point_sec} start` - interval start timestamp
+     * - `{int128_t} open` - first price of interval
+     * - `{int128_t} high` - highest price of interval
+     * - `{int128_t} low` - lowest price of interval
+     * - `{int128_t} close` - last price of interval
+     * - `{asset} volume` - traded volume of quote
+     * - `{uint64_t} transactions` - total amount of transactions
+     *
+     * ### secondary index `byquote`
+     *
+     * - `{uint128_t}` - `quote` (high 64 bits) & `start` (low 64 bits)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "id": 42,
+     *     "quote": "EOS",
+     *     "start": "2020-07-10T15:00:00",
+     *     "open": "2609800000000000000",
+     *     "high": "2615000000000000000",
+     *     "low": "2601200000000000000",
+     *     "close": "2612300000000000000",
+     *     "volume": "1250.0000 EOS",
+     *     "transactions": 31
+     * }
+     * ```
+     */
+    struct [[eosio::table]] candle_row {
+        uint64_t            id;
+        symbol_code         quote;
+        time_point_sec      start;
+        int128_t            open;
+        int128_t            high;
+        int128_t            low;
+        int128_t            close;
+        asset               volume;
+        uint64_t            transactions;
+
+        uint64_t primary_key() const { return id; }
+        uint128_t by_quote() const { return candle_key( quote, start.sec_since_epoch() ); }
+    };
+    typedef eosio::multi_index< "candles.m"_n, candle_row,
+        indexed_by<"byquote"_n, const_mem_fun<candle_row, uint128_t, &candle_row::by_quote>>
+    > candles_minute;
+    typedef eosio::multi_index< "candles.h"_n, candle_row,
+        indexed_by<"byquote"_n, const_mem_fun<candle_row, uint128_t, &candle_row::by_quote>>
+    > candles_hourly;
+    typedef eosio::multi_index< "candles.d"_n, candle_row,
+        indexed_by<"byquote"_n, const_mem_fun<candle_row, uint128_t, &candle_row::by_quote>>
+    > candles_daily;
+
+    static uint128_t candle_key( const symbol_code quote, const uint32_t start ) {
+        return ( uint128_t{ quote.raw() } << 64 ) | start;
+    }
+
+    /**
+     * ## TABLE `activity`
+     *
+     * Last activity of contracts, written alongside `volume.v2`, `flash.v2`, `trades.v2` & `gateway.v2` rows
+     *
+     * > scoped by table name (ex: `volume.v2`), contracts appear once active after deployment
+     *
+     * - `{name} contract` - (primary key) contract name
+     * - `{time_point_sec} last_modified` - last modified timestamp
+     *
+     * ### secondary index `bymodified`
+     *
+     * - `{uint64_t} last_modified` - seconds since epoch
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "contract": "swap.sx",
+     *     "last_modified": "2020-07-10T15:17:23"
+     * }
+     * ```
+     */
+    struct [[eosio::table("activity")]] activity_row {
+        name                contract;
+        time_point_sec      last_modified;
+
+        uint64_t primary_key() const { return contract.value; }
+        uint64_t by_modified() const { return last_modified.sec_since_epoch(); }
+    };
+    typedef eosio::multi_index< "activity"_n, activity_row,
+        indexed_by<"bymodified"_n, const_mem_fun<activity_row, uint64_t, &activity_row::by_modified>>
+    > activity;
+
+    /**
+     * ## TABLE `rebuilds`
+     *
+     * Progress of a pending `rebuild` per table, erased once every contract row is added to totals
+     *
+     * > while pending, logs of contracts at or after `cursor` are left out of totals (added when scanned)
+     *
+     * - `{name} table` - (primary key) table name (ex: `volume.v2`)
+     * - `{name} cursor` - next contract to add to totals
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "table": "volume.v2",
+     *     "cursor": "swap.sx"
+     * }
+     * ```
+     */
+    struct [[eosio::table("rebuilds")]] rebuilds_row {
+        name                table;
+        name                cursor;
+
+        uint64_t primary_key() const { return table.value; }
+    };
+    typedef eosio::multi_index< "rebuilds"_n, rebuilds_row > rebuilds;
+
+    /**
+     * ## TABLE `symbols`
+     *
+     * Symbol codes of `*.v2` rows with ids used by `getcolumns`, ids never change once assigned
+     *
+     * > registered when a symbol code is first written to a contract row or totals (including `setrows`, `migrate` & `rebuild`)
+     *
+     * - `{uint64_t} id` - (primary key) symbol id
+     * - `{symbol_code} symcode` - symbol code
+     *
+     * ### secondary index `bysymcode`
+     *
+     * - `{uint64_t} symcode` - raw symbol code
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "id": 0,
+     *     "symcode": "EOS"
+     * }
+     * ```
+     */
+    struct [[eosio::table("symbols")]] symbols_row {
+        uint64_t            id;
+        symbol_code         symcode;
+
+        uint64_t primary_key() const { return id; }
+        uint64_t by_symcode() const { return symcode.raw(); }
+    };
+    typedef eosio::multi_index< "symbols"_n, symbols_row,
+        indexed_by<"bysymcode"_n, const_mem_fun<symbols_row, uint64_t, &symbols_row::by_symcode>>
+    > symbols;
+
+    /**
+     * ## TABLE `sizes`
+     *
+     * Log2 histogram of trade sizes per symbol, from `swaplog` (in & out), `tradelog` (borrow) & `gatewaylog` (in & out)
+     *
+     * > scoped by contract, `buckets[i]` counts amounts within `[2^i, 2^(i+1))` (raw units), only grown up to the largest bucket used
+     *
+     * - `{symbol_code} symcode` - (primary key) symbol code
+     * - `{uint8_t} precision` - symbol precision
+     * - `{vector<uint64_t>} buckets` - number of trades per log2 bucket
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "symcode": "EOS",
+     *     "precision": 4,
+     *     "buckets": [0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 4, 12, 30, 41, 25, 9, 2]
+     * }
+     * ```
+     */
+    struct [[eosio::table("sizes")]] sizes_row {
+        symbol_code         symcode;
+        uint8_t             precision;
+        vector<uint64_t>    buckets;
+
+        uint64_t primary_key() const { return symcode.raw(); }
+    };
+    typedef eosio::multi_index< "sizes"_n, sizes_row > sizes;
+
+    /**
+     * ## STRUCT `sizes_result`
+     *
+     * Approximate trade size percentiles, interpolated within log2 buckets
+     *
+     * - `{uint64_t} transactions` - number of trades
+     * - `{asset} p50` - median trade size
+     * - `{asset} p95` - 95th percentile trade size
+     * - `{asset} p99` - 99th percentile trade size
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "transactions": 124,
+     *     "p50": "1.6384 EOS",
+     *     "p95": "6.9632 EOS",
+     *     "p99": "11.2640 EOS"
+     * }
+     * ```
+     */
+    struct sizes_result {
+        uint64_t        transactions;
+        asset           p50;
+        asset           p95;
+        asset           p99;
+    };
+
+    /**
+     * ## STRUCT `totals_result`
+     *
+     * Totals of all contracts, `contract` of each row is `get_self()`
+     *
+     * - `{volume_row} volume` - sum of `volume.v2` rows
+     * - `{flash_row} flash` - sum of `flash.v2` rows
+     * - `{trades_row} trades` - sum of `trades.v2` rows
+     * - `{gateway_row} gateway` - sum of `gateway.v2` rows
+     */
+    struct totals_result {
+        volume_row      volume;
+        flash_row       flash;
+        trades_row      trades;
+        gateway_row     gateway;
+    };
+
+    /**
+     * ## STRUCT `stats_result`
+     *
+     * All stats of a single contract
+     *
+     * - `{optional<volume_row>} volume` - `volume.v2` row
+     * - `{optional<flash_row>} flash` - `flash.v2` row
+     * - `{vector<prices_row>} prices` - `prices` rows
+     * - `{optional<trades_row>} trades` - `trades.v2` row
+     * - `{optional<gateway_row>} gateway` - `gateway.v2` row
+     */
+    struct stats_result {
+        optional<volume_row>        volume;
+        optional<flash_row>         flash;
+        vector<prices_row>          prices;
+        optional<trades_row>        trades;
+        optional<gateway_row>       gateway;
+    };
+
+    /**
+     * ## STRUCT `symbol_result`
+     *
+     * Rows of every contract using a symbol code, filtered to that symbol code only
+     *
+     * - `{vector<volume_row>} volume` - `volume.v2` rows
+     * - `{vector<flash_row>} flash` - `flash.v2` rows
+     * - `{vector<trades_row>} trades` - `trades.v2` rows
+     * - `{vector<gateway_row>} gateway` - `gateway.v2` rows
+     */
+    struct symbol_result {
+        vector<volume_row>          volume;
+        vector<flash_row>           flash;
+        vector<trades_row>          trades;
+        vector<gateway_row>         gateway;
+    };
+
+    /**
+     * ## STRUCT `columns_result`
+     *
+     * Columnar export of `*.v2` rows, field names & symbol codes are encoded as ids that are the same across pages & calls
+     *
+     * > one value per row in `contracts`, `last_modified` & `transactions`,
+     * > one value per per-symbol entry in `entry_*` columns (transaction counts use field `*.tx` with precision `0`)
+     *
+     * - `{vector<name>} contracts` - contract of each row
+     * - `{vector<uint32_t>} last_modified` - last modified of each row (seconds since epoch)
+     * - `{vector<uint64_t>} transactions` - transactions of each row
+     * - `{vector<name>} fields` - field names by field id (fixed list, same for every table)
+     * - `{vector<uint32_t>} entry_rows` - row index of each entry
+     * - `{vector<uint8_t>} entry_fields` - field id of each entry
+     * - `{vector<uint32_t>} entry_symcodes` - symbol id of each entry (`id` in `symbols` table)
+     * - `{vector<uint8_t>} entry_precisions` - precision of each entry
+     * - `{vector<int64_t>} entry_amounts` - amount of each entry
+     * - `{name} next` - cursor of next call (`""` when done)
+     *
+     * ### example
+     *
+     * ```json
+     * {
+     *     "contracts": ["swap.sx"],
+     *     "last_modified": [1591142400],
+     *     "transactions": [110],
+     *     "fields": ["volume", "fees", "borrow", "reserves", "quantities", "symcodes", "profits", "ins", "ins.tx", "outs", "outs.tx", "savings"],
+     *     "entry_rows": [0, 0, 0, 0],
+     *     "entry_fields": [0, 0, 1, 1],
+     *     "entry_symcodes": [0, 1, 0, 1],
+     *     "entry_precisions": [4, 4, 4, 4],
+     *     "entry_amounts": [250000, 1000000, 1250, 5000],
+     *     "next": ""
+     * }
+     * ```
+     */
+    struct columns_result {
+        vector<name>            contracts;
+        vector<uint32_t>        last_modified;
+        vector<uint64_t>        transactions;
+        vector<name>            fields;
+        vector<uint32_t>        entry_rows;
+        vector<uint8_t>         entry_fields;
+        vector<uint32_t>        entry_symcodes;
+        vector<uint8_t>         entry_precisions;
+        vector<int64_t>         entry_amounts;
+        name                    next;
+    };
+
+    /**
+     * ## STRUCT `swaplog_record`
+     *
+     * - `{name} contract` - swap contract
+     * - `{name} buyer` - trader buyer account
+     * - `{asset} amount_in` - amount incoming
+     * - `{asset} amount_out` - amount outgoing
+     * - `{asset} fee` - fee paid
+     */
+    struct swaplog_record {
+        name            contract;
+        name            buyer;
+        asset           amount_in;
+        asset           amount_out;
+        asset           fee;
+    };
+
+    /**
+     * ## STRUCT `tradelog_record`
+     *
+     * - `{name} contract` - trade contract
+     * - `{name} executor` - executor account
+     * - `{asset} borrow` - borrowed quantity
+     * - `{vector<asset>} quantities` - quantities traded
+     * - `{vector<name>} codes` - contract codes used
+     * - `{asset} profit` - profit
+     */
+    struct tradelog_record {
+        name            contract;
+        name            executor;
+        asset           borrow;
+        vector<asset>   quantities;
+        vector<name>    codes;
+        asset           profit;
+    };
+
+    /**
+     * ## STRUCT `gatewaylog_record`
+     *
+     * - `{name} contract` - gateway contract
+     * - `{asset} in` - input quantity
+     * - `{asset} out` - output quantity
+     * - `{vector<name>} exchanges` - exchanges used
+     * - `{asset} savings` - savings
+     * - `{asset} fee` - fee
+     */
+    struct gatewaylog_record {
+        name            contract;
+        asset           in;
+        asset           out;
+        vector<name>    exchanges;
+        asset           savings;
+        asset           fee;
+    };
+
+    // flash.sx::flashlog notification with current vault reserve
+    struct flashlog_record {
+        name            contract;
+        asset           borrow;
+        asset           fee;
+        asset           reserve;
+    };
+
+    /**
+     * ## ACTION `erase`
+     *
+     * Erase rows of contract in `volume.v2`, `flash.v2`, `trades.v2`, `gateway.v2`, legacy tables & `spotprices`
+     *
+     * > contract scoped tables (buckets, counters, prices, twap, candles...) are removed by `purge`
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{name} contract` - contract to erase
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx erase '["basic.sx"]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    void erase( const name contract );
+
+    /**
+     * ## ACTION `purge`
+     *
+     * Delete contract across every table, at most `limit` rows per call (repeat until it fails with "no rows available to purge")
+     *
+     * > totals rows are kept, use `rebuild` to exclude the purged contract from totals
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{name} contract` - contract to delete
+     * - `{uint64_t} limit` - maximum rows erased
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx purge '["basic.sx", 200]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    void purge( const name contract, const uint64_t limit );
+
+    /**
+     * ## ACTION `prune`
+     *
+     * Remove dust entries (absolute amount at or below `dust`) from per-symbol vectors of a `*.v2` table,
+     * visiting at most `limit` rows starting at `cursor`
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{name} table` - `volume.v2`, `flash.v2`, `trades.v2` or `gateway.v2`
+     * - `{name} cursor` - first contract to visit (`""` from the start)
+     * - `{int64_t} dust` - maximum absolute amount removed (`0` for zero entries only)
+     * - `{uint64_t} limit` - maximum rows visited
+     *
+     * ### returns
+     *
+     * - `{name}` - cursor of next call (`""` when done)
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx prune '["volume.v2", "", 0, 100]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    name prune( const name table, const name cursor, const int64_t dust, const uint64_t limit );
+
+    /**
+     * ## ACTION `delist`
+     *
+     * Drop symbols no longer listed in swap contract `tokens` from `volume.v2`, `prices`, `twap` & candles,
+     * at most `limit` rows modified or erased per call (repeat until it fails with "no delisted symbols available")
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{name} contract` - swap contract
+     * - `{uint64_t} limit` - maximum rows modified or erased
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx delist '["swap.sx", 200]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    void delist( const name contract, const uint64_t limit );
+
+    /**
+     * ## ACTION `rebuild`
+     *
+     * Recompute reserved `get_self()` totals row of a `*.v2` table from every contract row,
+     * adding at most `limit` contract rows per call (repeat until it returns `""`)
+     *
+     * > required once after deployment and after `migrate` or `setrows` (those rows are not added to totals),
+     * > first call resets totals, which stay partial until the last call (progress in `rebuilds`),
+     * > symbol codes of scanned rows are registered in `symbols`
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{name} table` - `volume.v2`, `flash.v2`, `trades.v2` or `gateway.v2`
+     * - `{uint64_t} limit` - maximum contract rows added
+     *
+     * ### returns
+     *
+     * - `{name}` - next contract to add (`""` when done)
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx rebuild '["volume.v2", 100]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    name rebuild( const name table, const uint64_t limit );
+
+    /**
+     * ## ACTION `setrows`
+     *
+     * Overwrite `volume.v2`, `flash.v2`, `trades.v2` & `gateway.v2` rows with recomputed values (ex: replay of historical logs)
+     *
+     * > every row is checked before any is written: `*.sx` contracts unique per table, `last_modified` not in the future,
+     * > per-symbol entries with valid symbol codes & precisions, sorted by symbol code, run `rebuild` afterwards to refresh totals
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{vector<volume_row>} volume` - `volume.v2` rows
+     * - `{vector<flash_row>} flash` - `flash.v2` rows
+     * - `{vector<trades_row>} trades` - `trades.v2` rows
+     * - `{vector<gateway_row>} gateway` - `gateway.v2` rows
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx setrows '[[{"contract": "swap.sx", "last_modified": "2020-06-03T00:00:00", "transactions": 110, "volume": [{"symcode": "EOS", "precision": 4, "amount": 250000}], "fees": []}], [], [], []]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    void setrows( const vector<volume_row> volume, const vector<flash_row> flash, const vector<trades_row> trades, const vector<gateway_row> gateway );
+
+    /**
+     * ## ACTION `swaplog`
+     *
+     * Notify of trade
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{name} buyer` - trader buyer account
+     * - `{asset} amount_in` - amount incoming
+     * - `{asset} amount_out` - amount outgoing
+     * - `{asset} fee` - fee paid
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action swap.sx swaplog '["myaccount", "3.0000 EOS", "7.0486 USDT", "0.0060 EOS"]' -p swap.sx
+     * ```
+     */
+    [[eosio::action]]
+    void swaplog( const name contract, const name buyer, const asset amount_in, const asset amount_out, const asset fee );
+
+    [[eosio::action]]
+    void clean( const name contract );
+
+    /**
+     * ## ACTION `migrate`
+     *
+     * Move legacy `volume`, `flash`, `trades` & `gateway` rows of contract into `*.v2` tables
+     *
+     * > legacy `trades::codes`, `trades::executors` & `gateway::exchanges` entries are first drained into their scoped tables,
+     * > then each legacy row is merged into its `*.v2` row (one row per unit of `limit`),
+     * > deprecated `spotprices` row is removed (`prices` are recomputed on the next swap or `refresh`)
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{name} contract` - contract to migrate
+     * - `{uint64_t} limit` - maximum counter entries & rows moved
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx migrate '["basic.sx", 200]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    void migrate( const name contract, const uint64_t limit );
+
+    /**
+     * ## ACTION `setconfig`
+     *
+     * Set contract configuration (erase config if `null`)
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{config_row} [config=null]` - configuration
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx setconfig '[{"spotprices": false}]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    void setconfig( const optional<config_row> config );
+
+    /**
+     * ## ACTION `getprices`
+     *
+     * Read-only quotes of every token of swap contract relative to base, computed from current reserves
+     *
+     * ### params
+     *
+     * - `{name} contract` - swap contract
+     * - `{symbol_code} base` - base symbol code
+     *
+     * ### returns
+     *
+     * - `{vector<quote_price>}` - quotes prices (18 decimals fixed-point) calculated relative to base
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx getprices '["swap.sx", "USDT"]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    vector<quote_price> getprices( const name contract, const symbol_code base );
+
+    /**
+     * ## ACTION `gettotals`
+     *
+     * Read-only totals across all *.sx contracts
+     *
+     * > single read of the reserved `get_self()` rows, maintained on every log
+     *
+     * ### returns
+     *
+     * - `{totals_result}` - `get_self()` rows of `volume.v2`, `flash.v2`, `trades.v2` & `gateway.v2`
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx gettotals '[]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    totals_result gettotals();
+
+    /**
+     * ## ACTION `getstats`
+     *
+     * Read-only stats of a contract joined across `volume.v2`, `flash.v2`, `prices`, `trades.v2` & `gateway.v2`
+     *
+     * ### params
+     *
+     * - `{name} contract` - contract name
+     *
+     * ### returns
+     *
+     * - `{stats_result}` - contract rows
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx getstats '["swap.sx"]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    stats_result getstats( const name contract );
+
+    /**
+     * ## ACTION `getsymbol`
+     *
+     * Read-only stats of every contract filtered by symbol code
+     *
+     * ### params
+     *
+     * - `{symbol_code} symcode` - symbol code
+     *
+     * ### returns
+     *
+     * - `{symbol_result}` - rows containing symbol code, other symbols removed
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx getsymbol '["EOS"]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    symbol_result getsymbol( const symbol_code symcode );
+
+    /**
+     * ## ACTION `gettraders`
+     *
+     * Read-only estimate of unique traders of contract
+     *
+     * ### params
+     *
+     * - `{name} contract` - contract name
+     * - `{uint32_t} days` - number of last daily buckets to include (`0` for all-time)
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - estimated unique traders
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx gettraders '["swap.sx", 1]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    uint64_t gettraders( const name contract, const uint32_t days );
+
+    /**
+     * ## ACTION `gettwap`
+     *
+     * Read-only time-weighted average price of quote
+     *
+     * > window starts at the newest checkpoint at least `seconds` old (checkpoints are hourly, window can be up to an hour longer),
+     * > fails when `seconds` reaches past the oldest checkpoint
+     *
+     * ### params
+     *
+     * - `{name} contract` - swap contract
+     * - `{symbol_code} quote` - quote symbol code
+     * - `{uint32_t} seconds` - window length in seconds
+     *
+     * ### returns
+     *
+     * - `{int128_t}` - average price (18 decimals fixed-point) relative to `twap::base`
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx gettwap '["swap.sx", "EOS", 3600]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    int128_t gettwap( const name contract, const symbol_code quote, const uint32_t seconds );
+
+    /**
+     * ## ACTION `getsizes`
+     *
+     * Read-only approximate trade size percentiles of a symbol from `sizes` histogram
+     *
+     * ### params
+     *
+     * - `{name} contract` - contract
+     * - `{symbol_code} symcode` - symbol code
+     *
+     * ### returns
+     *
+     * - `{sizes_result}` - number of trades & p50, p95, p99 trade sizes
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx getsizes '["swap.sx", "EOS"]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    sizes_result getsizes( const name contract, const symbol_code symcode );
+
+    /**
+     * ## ACTION `getcolumns`
+     *
+     * Read-only columnar export of a `*.v2` table, at most `limit` rows starting at `cursor`
+     *
+     * > symbol ids refer to `symbols` table, fails if a symbol code is not registered (rows written before `symbols` existed, run `rebuild` of the table)
+     *
+     * ### params
+     *
+     * - `{name} table` - `volume.v2`, `flash.v2`, `trades.v2` or `gateway.v2`
+     * - `{name} cursor` - first contract exported (`""` from the start)
+     * - `{uint32_t} limit` - maximum rows exported
+     *
+     * ### returns
+     *
+     * - `{columns_result}` - columns of exported rows
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx getcolumns '["volume.v2", "", 100]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    columns_result getcolumns( const name table, const name cursor, const uint32_t limit );
+
+    /**
+     * ## ACTION `getactive`
+     *
+     * Read-only contracts of a table active since timestamp, oldest first (range scan of `activity` by `last_modified`)
+     *
+     * ### params
+     *
+     * - `{name} table` - `volume.v2`, `flash.v2`, `trades.v2` or `gateway.v2`
+     * - `{time_point_sec} since` - minimum last modified timestamp
+     * - `{uint32_t} limit` - maximum rows returned
+     *
+     * ### returns
+     *
+     * - `{vector<activity_row>}` - active contracts & last modified timestamp
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx getactive '["volume.v2", "2020-07-10T14:00:00", 100]' -p stats.sx --read-only
+     * ```
+     */
+    [[eosio::action, eosio::read_only]]
+    vector<activity_row> getactive( const name table, const time_point_sec since, const uint32_t limit );
+
+    /**
+     * ## ACTION `refresh`
+     *
+     * Full refresh of `prices` quotes for every token of contract, ignoring `config.throttle`
+     *
+     * > `swaplog` only recomputes quotes of the traded symbols & base
+     *
+     * - **authority**: `get_self()`
+     *
+     * ### params
+     *
+     * - `{name} contract` - swap contract
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx refresh '["swap.sx"]' -p stats.sx
+     * ```
+     */
+    [[eosio::action]]
+    void refresh( const name contract );
+
+    [[eosio::on_notify("flash.sx::flashlog")]]
+    void on_flashlog( const name code, const name receiver, const extended_asset amount, const asset fee );
+
+    /**
+     * ## NOTIFY `*::swaplog`, `*::tradelog` & `*::gatewaylog`
+     *
+     * Same as `swaplog`, `tradelog` & `gatewaylog` when a *.sx contract adds `stats.sx` as recipient of its own log action,
+     * contract is the first receiver (saves the inline action)
+     *
+     * > a contract should either notify or push the log action, not both (trades would be counted twice)
+     *
+     * ### example
+     *
+     * ```c++
+     * void swaplog( const name buyer, const asset amount_in, const asset amount_out, const asset fee )
+     * {
+     *     require_auth( get_self() );
+     *     require_recipient( "stats.sx"_n );
+     * }
+     * ```
+     */
+    [[eosio::on_notify("*::swaplog")]]
+    void on_swaplog( const name buyer, const asset amount_in, const asset amount_out, const asset fee );
+
+    [[eosio::on_notify("*::tradelog")]]
+    void on_tradelog( const name executor, const asset borrow, const vector<asset> quantities, const vector<name> codes, const asset profit );
+
+    [[eosio::on_notify("*::gatewaylog")]]
+    void on_gatewaylog( const asset in, const asset out, const vector<name> exchanges, const asset savings, const asset fee );
+
+    [[eosio::action]]
+    void tradelog( const name contract, const name executor, const asset borrow, const vector<asset> quantities, const vector<name> codes, const asset profit );
+
+    [[eosio::action]]
+    void gatewaylog(const name contract, const asset in, const asset out, const vector<name> exchanges, const asset savings, const asset fee );
+
+    /**
+     * ## ACTION `swaplogs`
+     *
+     * Batch of `swaplog` records, each contract row is loaded & saved once
+     *
+     * - **authority**: each record `contract`
+     *
+     * ### params
+     *
+     * - `{vector<swaplog_record>} records` - swap logs
+     *
+     * ### example
+     *
+     * ```bash
+     * cleos push action stats.sx swaplogs '[[["swap.sx", "myaccount", "3.0000 EOS", "7.0486 USDT", "0.0060 EOS"], ["swap.sx", "myaccount", "7.0486 USDT", "2.9910 EOS", "0.0141 USDT"]]]' -p swap.sx
+     * ```
+     */
+    [[eosio::action]]
+    void swaplogs( const vector<swaplog_record> records );
+
+    /**
+     * ## ACTION `tradelogs`
+     *
+     * Batch of `tradelog` records, each contract row is loaded & saved once
+     *
+     * - **authority**: each record `contract`
+     *
+     * ### params
+     *
+     * - `{vector<tradelog_record>} records` - trade logs
+     */
+    [[eosio::action]]
+    void tradelogs( const vector<tradelog_record> records );
+
+    /**
+     * ## ACTION `gatewaylogs`
+     *
+     * Batch of `gatewaylog` records, each contract row is loaded & saved once
+     *
+     * - **authority**: each record `contract`
+     *
+     * ### params
+     *
+     * - `{vector<gatewaylog_record>} records` - gateway logs
+     */
+    [[eosio::action]]
+    void gatewaylogs( const vector<gatewaylog_record> records );
+
+    // action wrappers
+    using swaplog_action = eosio::action_wrapper<"swaplog"_n, &sx::stats::swaplog>;
+    using tradelog_action = eosio::action_wrapper<"tradelog"_n, &sx::stats::tradelog>;
+    using gatewaylog_action = eosio::action_wrapper<"gatewaylog"_n, &sx::stats::gatewaylog>;
+    using getprices_action = eosio::action_wrapper<"getprices"_n, &sx::stats::getprices>;
+    using gettotals_action = eosio::action_wrapper<"gettotals"_n, &sx::stats::gettotals>;
+    using getstats_action = eosio::action_wrapper<"getstats"_n, &sx::stats::getstats>;
+    using getsymbol_action = eosio::action_wrapper<"getsymbol"_n, &sx::stats::getsymbol>;
+    using gettraders_action = eosio::action_wrapper<"gettraders"_n, &sx::stats::gettraders>;
+    using gettwap_action = eosio::action_wrapper<"gettwap"_n, &sx::stats::gettwap>;
+    using getsizes_action = eosio::action_wrapper<"getsizes"_n, &sx::stats::getsizes>;
+    using getcolumns_action = eosio::action_wrapper<"getcolumns"_n, &sx::stats::getcolumns>;
+    using getactive_action = eosio::action_wrapper<"getactive"_n, &sx::stats::getactive>;
+    using swaplogs_action = eosio::action_wrapper<"swaplogs"_n, &sx::stats::swaplogs>;
+    using tradelogs_action = eosio::action_wrapper<"tradelogs"_n, &sx::stats::tradelogs>;
+    using gatewaylogs_action = eosio::action_wrapper<"gatewaylogs"_n, &sx::stats::gatewaylogs>;
+
+private:
+    // native tools (`native/`) reach write paths through `native_access`
+    friend struct native_access;
+
+    // config
+    config_row get_config();
+
+    // rolling buckets
+    static constexpr uint32_t HOUR = 3600;
+    static constexpr uint32_t DAY = 86400;
+    static constexpr uint32_t HOURLY_BUCKETS = 48;
+    static constexpr uint32_t DAILY_BUCKETS = 90;
+
+    template <typename T, typename Updater>
+    void update_bucket( const name contract, const uint32_t interval, const uint32_t capacity, const Updater & updater );
+
+    template <typename T>
+    static map<name, vector<T>> group_by_contract( const vector<T> & records );
+
+    // counters
+    template <typename T>
+    void add_counters( const name contract, const map<name, uint64_t> & counters );
+
+    template <typename T>
+    void add_hitters( const name contract, const map<name, uint64_t> & counters, const uint32_t capacity );
+
+    static void add_hitter( vector<hitter> & hitters, const name key, const uint64_t transactions, const uint32_t capacity );
+
+    static uint64_t drain_counters( map<name, uint64_t> & from, map<name, uint64_t> & to, const uint64_t limit );
+
+    // traders (HyperLogLog)
+    static constexpr uint8_t HLL_PRECISION = 8;
+
+    void update_traders( const name contract, const vector<name> & traders );
+    static void add_register( vector<uint8_t> & registers, const name trader );
+    static void merge_registers( vector<uint8_t> & registers, const vector<uint8_t> & others );
+    static uint64_t estimate_cardinality( const vector<uint8_t> & registers );
+
+    // volume
+    void update_volume( const name contract, const vector<swaplog_record> & records, const config_row & config );
+
+    // trades
+    void update_trades( const name contract, const vector<tradelog_record> & records, const config_row & config );
+
+    // gateway
+    void update_gateway( const name contract, const vector<gatewaylog_record> & records, const config_row & config );
+
+    // filter rows to a single symbol code, false if row has no entry left
+    static bool filter( volume_row & row, const symbol_code symcode );
+    static bool filter( flash_row & row, const symbol_code symcode );
+    static bool filter( trades_row & row, const symbol_code symcode );
+    static bool filter( gateway_row & row, const symbol_code symcode );
+
+    // columns (field ids are positions in `COLUMN_FIELDS`, append only)
+    static constexpr name COLUMN_FIELDS[] = { "volume"_n, "fees"_n, "borrow"_n, "reserves"_n, "quantities"_n, "symcodes"_n, "profits"_n, "ins"_n, "ins.tx"_n, "outs"_n, "outs.tx"_n, "savings"_n };
+
+    template <typename T>
+    columns_result get_columns( const name cursor, const uint32_t limit );
+
+    void add_columns( columns_result & result, const volume_row & row );
+    void add_columns( columns_result & result, const flash_row & row );
+    void add_columns( columns_result & result, const trades_row & row );
+    void add_columns( columns_result & result, const gateway_row & row );
+    void add_column( columns_result & result, const name field, const vector<flat_asset> & entries );
+    void add_column( columns_result & result, const name field, const name counts_field, const vector<flat_counted_asset> & entries );
+    void add_column( columns_result & result, const name field, const map<symbol_code, uint64_t> & counts );
+    void add_entry( columns_result & result, const name field, const symbol_code symcode, const uint8_t precision, const int64_t amount );
+
+    static uint8_t get_field_id( const name field );
+    uint32_t get_symbol_id( const symbol_code symcode );
+
+    // symbols
+    void add_symbols( const set<symbol_code> & symcodes );
+
+    static void get_symcodes( const volume_row & row, set<symbol_code> & symcodes );
+    static void get_symcodes( const flash_row & row, set<symbol_code> & symcodes );
+    static void get_symcodes( const trades_row & row, set<symbol_code> & symcodes );
+    static void get_symcodes( const gateway_row & row, set<symbol_code> & symcodes );
+
+    template <typename T>
+    static void get_symcodes( const vector<T> & entries, set<symbol_code> & symcodes );
+
+    static size_t count_entries( const volume_row & row );
+    static size_t count_entries( const flash_row & row );
+    static size_t count_entries( const trades_row & row );
+    static size_t count_entries( const gateway_row & row );
+
+    template <typename T>
+    static bool filter_entries( vector<T> & entries, const symbol_code symcode );
+
+    template <typename T, typename Updater>
+    void upsert( const name contract, const Updater & updater );
+
+    template <typename T, typename R>
+    void add_totals( const name table, const name contract, const R & delta );
+
+    template <typename T>
+    name rebuild_totals( const name table, const uint64_t limit );
+
+    // activity
+    void update_activity( const name table, const name contract );
+
+    // sizes
+    void update_sizes( const name contract, const vector<asset> & quantities );
+    static void add_size( vector<uint64_t> & buckets, const int64_t amount );
+    static int64_t get_percentile( const vector<uint64_t> & buckets, const uint64_t transactions, const uint8_t percentile );
+
+    // maintenance
+    template <typename T>
+    uint64_t erase_row( const name contract, const uint64_t limit );
+
+    template <typename T>
+    uint64_t erase_scope( const name scope, const uint64_t limit );
+
+    template <typename T>
+    uint64_t erase_candles( const name contract, const symbol_code quote, const uint64_t limit );
+
+    template <typename T>
+    name prune_rows( const name cursor, const int64_t dust, const uint64_t limit );
+
+    template <typename T, typename Predicate>
+    static bool erase_entries( vector<T> & entries, const Predicate & predicate );
+
+    template <typename T, typename R>
+    void set_rows( const vector<R> & rows );
+
+    template <typename R>
+    void check_rows( const vector<R> & rows );
+
+    template <typename T>
+    static void check_entries( const vector<T> & entries );
+
+    static void check_row( const volume_row & row );
+    static void check_row( const flash_row & row );
+    static void check_row( const trades_row & row );
+    static void check_row( const gateway_row & row );
+
+    static bool prune_row( volume_row & row, const int64_t dust );
+    static bool prune_row( flash_row & row, const int64_t dust );
+    static bool prune_row( trades_row & row, const int64_t dust );
+    static bool prune_row( gateway_row & row, const int64_t dust );
+
+    // spotprices
+    static constexpr symbol_code BASE_SYMCODE = symbol_code{"USDT"};
+    static constexpr uint8_t PRICE_PRECISION = 18;
+    static constexpr int128_t PRICE_UNIT = 1'000'000'000'000'000'000;
+    static constexpr int128_t MAX_PRICE = ( int128_t( 1 ) << 96 ) - 1;
+
+    void update_spot_prices( const name contract, const vector<symbol_code> & bases, const map<symbol_code, vector<quote_price>> & matrix, const config_row & config );
+    static bool has_moved( const prices_row & row, const vector<quote_price> & quotes, const uint32_t threshold );
+    void refresh_spot_prices( const name contract, const vector<symbol_code> & bases );
+    map<symbol_code, vector<quote_price>> get_spot_prices( const name contract, const vector<symbol_code> & bases, const set<symbol_code> & symcodes );
+    static vector<symbol_code> get_bases( const config_row & config );
+    static int128_t div_price( const asset numerator, const asset denominator );
+    static int128_t div_fixed( const int128_t numerator, const int128_t denominator, int exponent );
+    static void set_quote( vector<quote_price> & quotes, const symbol_code symcode, const int128_t price );
+
+    // candles
+    static constexpr uint32_t MINUTE = 60;
+
+    template <typename T>
+    void update_candles( const name contract, const uint32_t interval, const uint32_t capacity, const symbol_code base, const vector<quote_price> & quotes, const map<symbol_code, asset> & volumes, const map<symbol_code, uint64_t> & transactions );
+
+    // twap
+    void update_twap( const name contract, const symbol_code base, const vector<quote_price> & quotes );
+    static void add_checkpoint( vector<checkpoint> & checkpoints, const time_point_sec timestamp, const uint128_t cumulative );
 };
 }
\ No newline at end of file